@@ -1,6 +0,0 @@
-#pragma once
-
-// Base component - no Init()
-struct Component {
-    virtual void Destroy() = 0;
-};
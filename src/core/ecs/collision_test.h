@@ -0,0 +1,57 @@
+#ifndef COLLISION_TEST_H
+#define COLLISION_TEST_H
+
+#include "entity.h"
+#include "components.h"
+#include "systems/collision_system.h"
+#include <stdio.h>
+
+// Adds a dynamic 32x32 collider at (x, 0)
+inline EntityID AddTestCollider(EntityManager* manager, ComponentArrays* components, float x) {
+    EntityID entity = manager->CreateEntity();
+    manager->AddComponentToEntity(entity, COMPONENT_TRANSFORM | COMPONENT_COLLIDER);
+    components->transforms[entity].Init(x, 0.0f);
+    components->colliders[entity].Init(32.0f, 32.0f);
+    return entity;
+}
+
+// Resolves that chain: one resolve pushes a collider into another one, and
+// that pair still has to be found in the same step, like the old all-pairs
+// loop testing current positions did.
+inline void TestCollisionSystem() {
+    printf("\n=== Testing Collision System ===\n");
+
+    EntityManager manager;
+    manager.Init();
+    ComponentArrays* components = new ComponentArrays();
+    components->Init();
+    static CollisionSystem collision;  // Zeroed, like the grids expect
+    collision.Init();
+
+    // Test 1: resolving (c, b) pushes b into a, which comes after c
+    printf("\nTest 1: Pushed into a later collider\n");
+    EntityID c = AddTestCollider(&manager, components, 0.0f);
+    EntityID a = AddTestCollider(&manager, components, 56.0f);
+    EntityID b = AddTestCollider(&manager, components, 20.0f);
+    collision.Update(0.0f, &manager, components);
+    printf("Collisions (expect 2): %d\n", collision.collisionCount);
+    printf("b at %.0f, a at %.0f (expect 25 57)\n", components->transforms[b]->x, components->transforms[a]->x);
+    manager.DestroyEntity(a);
+    manager.DestroyEntity(b);
+    manager.DestroyEntity(c);
+
+    // Test 2: resolving (a, c) pushes a itself into d, away from its first query
+    printf("\nTest 2: Pushed out of its own query\n");
+    a = AddTestCollider(&manager, components, 0.0f);
+    c = AddTestCollider(&manager, components, 20.0f);
+    EntityID d = AddTestCollider(&manager, components, -36.0f);
+    collision.Update(0.0f, &manager, components);
+    printf("Collisions (expect 2): %d\n", collision.collisionCount);
+    printf("d at %.0f, a at %.0f (expect -37 -5)\n", components->transforms[d]->x, components->transforms[a]->x);
+
+    collision.Destroy();
+    components->Destroy();
+    delete components;
+    manager.Destroy();
+}
+#endif // COLLISION_TEST_H
@@ -0,0 +1,134 @@
+#ifndef COMPONENT_LAYOUT_BENCH_H
+#define COMPONENT_LAYOUT_BENCH_H
+
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_LAYOUT_ENTITIES 100000
+#define BENCH_LAYOUT_ITERATIONS 200
+
+// The old component layout: a vtable pointer from the virtual Destroy in
+// front of the fields, one struct per entity
+struct BenchAoSTransform {
+    virtual void Destroy() {}
+    float x, y;
+    float rotation;
+    float scale;
+    float prevX, prevY;
+    float prevRotation;
+};
+
+struct BenchAoSCollider {
+    virtual void Destroy() {}
+    float width;
+    float height;
+    bool isTrigger;
+    bool isStatic;
+};
+
+// Compares array-of-structs against the structure-of-arrays stores for the
+// loops the engine runs every fixed step: saving previous transforms, moving
+// everything, and finding the largest collider (CollisionSystem's cell size).
+inline void BenchmarkComponentLayout() {
+    printf("\n=== Component layout benchmark: %d entities x %d steps ===\n",
+           BENCH_LAYOUT_ENTITIES, BENCH_LAYOUT_ITERATIONS);
+    printf("AoS transform: %d bytes per entity, SoA: %d\n",
+           (int)sizeof(BenchAoSTransform), (int)(7 * sizeof(float)));
+
+    const int n = BENCH_LAYOUT_ENTITIES;
+    const float dt = 1.0f / 120.0f;
+
+    BenchAoSTransform* aosTransforms = new BenchAoSTransform[n];
+    BenchAoSCollider* aosColliders = new BenchAoSCollider[n];
+
+    float* x = new float[n];
+    float* y = new float[n];
+    float* rotation = new float[n];
+    float* prevX = new float[n];
+    float* prevY = new float[n];
+    float* prevRotation = new float[n];
+    float* width = new float[n];
+    float* height = new float[n];
+    float* velocityY = new float[n];
+
+    srand(5);
+    for (int i = 0; i < n; i++) {
+        float px = (float)(rand() % 2400);
+        float py = (float)(rand() % 60000);
+        float size = 16.0f + (float)(rand() % 33);
+
+        aosTransforms[i].x = x[i] = px;
+        aosTransforms[i].y = y[i] = py;
+        aosTransforms[i].rotation = rotation[i] = 0.0f;
+        aosTransforms[i].scale = 1.0f;
+        aosColliders[i].width = width[i] = size;
+        aosColliders[i].height = height[i] = size;
+        aosColliders[i].isStatic = false;
+        aosColliders[i].isTrigger = false;
+        velocityY[i] = (float)(rand() % 400);
+    }
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    // AoS: every loop drags whole structs through the cache
+    Uint64 start = SDL_GetPerformanceCounter();
+    float aosExtent = 0.0f;
+    for (int step = 0; step < BENCH_LAYOUT_ITERATIONS; step++) {
+        for (int i = 0; i < n; i++) {
+            aosTransforms[i].prevX = aosTransforms[i].x;
+            aosTransforms[i].prevY = aosTransforms[i].y;
+            aosTransforms[i].prevRotation = aosTransforms[i].rotation;
+        }
+        for (int i = 0; i < n; i++) {
+            aosTransforms[i].y += velocityY[i] * dt;
+        }
+        for (int i = 0; i < n; i++) {
+            if (aosColliders[i].width > aosExtent) aosExtent = aosColliders[i].width;
+            if (aosColliders[i].height > aosExtent) aosExtent = aosColliders[i].height;
+        }
+    }
+    double aosMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+    // SoA: straight copies and unit-stride float loops the compiler vectorizes
+    start = SDL_GetPerformanceCounter();
+    float soaExtent = 0.0f;
+    for (int step = 0; step < BENCH_LAYOUT_ITERATIONS; step++) {
+        memcpy(prevX, x, n * sizeof(float));
+        memcpy(prevY, y, n * sizeof(float));
+        memcpy(prevRotation, rotation, n * sizeof(float));
+        for (int i = 0; i < n; i++) {
+            y[i] += velocityY[i] * dt;
+        }
+        for (int i = 0; i < n; i++) {
+            soaExtent = width[i] > soaExtent ? width[i] : soaExtent;
+            soaExtent = height[i] > soaExtent ? height[i] : soaExtent;
+        }
+    }
+    double soaMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+    // Same arithmetic in the same order, so the results have to match exactly
+    bool match = aosExtent == soaExtent;
+    for (int i = 0; i < n && match; i++) {
+        match = aosTransforms[i].y == y[i] && aosTransforms[i].prevY == prevY[i];
+    }
+
+    printf("AoS: %.3f ms (%.3f ms per step)\n", aosMs, aosMs / BENCH_LAYOUT_ITERATIONS);
+    printf("SoA: %.3f ms (%.3f ms per step), %.2fx\n", soaMs, soaMs / BENCH_LAYOUT_ITERATIONS, aosMs / soaMs);
+    printf("Results match: %s\n", match ? "yes" : "NO");
+
+    delete[] aosTransforms;
+    delete[] aosColliders;
+    delete[] x;
+    delete[] y;
+    delete[] rotation;
+    delete[] prevX;
+    delete[] prevY;
+    delete[] prevRotation;
+    delete[] width;
+    delete[] height;
+    delete[] velocityY;
+}
+
+#endif // COMPONENT_LAYOUT_BENCH_H
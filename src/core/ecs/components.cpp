@@ -2,74 +2,90 @@
 #include <stdio.h>
 #include "../engine.h"
 
-void* ComponentArrays::GetComponentData(EntityID entity, ComponentType type) {
-    if (entity >= MAX_ENTITIES) {
-        printf("Warning: Entity ID %u out of bounds\n", entity);
-        return nullptr;
-    }
+void ComponentArrays::Destroy() {
+    printf("Component pages: %u KB\n", (unsigned)(AllocatedBytes() / 1024));
 
-    switch (type) {
-        case COMPONENT_TRANSFORM: return &transforms[entity];
-        case COMPONENT_SPRITE:    return &sprites[entity];
-        case COMPONENT_WASD_CONTROLLER: return &wasdControllers[entity];
-        case COMPONENT_COLLIDER:  return &colliders[entity];
-        case COMPONENT_ANIMATION:  return &animations[entity];
-        case COMPONENT_GRAVITY:  return &gravities[entity];
-        case COMPONENT_SQUIRREL:  return &squirrelComponents[entity];
-        case COMPONENT_CAMERA:  return &cameras[entity];
-        case COMPONENT_CLOUD: return &clouds[entity];
-        case COMPONENT_BACKGROUND: return &backgrounds[entity];
-        case COMPONENT_PEANUT: return &peanuts[entity];
-
-        default:
-            printf("Warning: Unknown component type %u\n", type);
-            return nullptr;
-    }
+#define DESTROY_STORE(Type, member, bit) member.Destroy();
+    COMPONENT_LIST(DESTROY_STORE)
+#undef DESTROY_STORE
+}
+
+size_t ComponentArrays::AllocatedBytes() {
+    size_t bytes = 0;
+#define ADD_STORE_BYTES(Type, member, bit) bytes += member.AllocatedBytes();
+    COMPONENT_LIST(ADD_STORE_BYTES)
+#undef ADD_STORE_BYTES
+    return bytes;
 }
 
+// Per-type reset, in component bit order. Plain functions instead of a
+// virtual Destroy, so components carry no vtable pointer.
+typedef void (*ComponentResetFunc)(ComponentArrays* arrays, EntityID entity);
+
+template <typename T>
+static void ResetComponent(ComponentArrays* arrays, EntityID entity) {
+    arrays->Get<T>(entity).Destroy();
+}
+
+#define RESET_ENTRY(Type, member, bit) ResetComponent<Type>,
+static const ComponentResetFunc componentResetTable[COMPONENT_TYPE_COUNT] = {
+    COMPONENT_LIST(RESET_ENTRY)
+};
+#undef RESET_ENTRY
 
 void ComponentArrays::RemoveComponent(EntityID entity, ComponentType type) {
-    Component* component = (Component*)GetComponentData(entity, type);
-    if (component) {
-        component->Destroy();
+    if (!g_Engine.entityManager.IsEntityValid(entity)) {
+        printf("Warning: Entity ID %u is stale or invalid\n", entity);
+        return;
+    }
+
+    for (int bit = 0; bit < COMPONENT_TYPE_COUNT; bit++) {
+        if (type == (1u << bit)) {
+            componentResetTable[bit](this, entity);
+            return;
+        }
     }
+    printf("Warning: Unknown component type %u\n", type);
 }
 
 void InitTransform(EntityID entity, float x, float y, float rotation, float scale) {
-    TransformComponent* transform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_TRANSFORM);
-    if (transform) {
-        transform->Init(x, y, rotation, scale);
-    }
+    if (!g_Engine.entityManager.IsEntityValid(entity)) return;
+    g_Engine.componentArrays.transforms[entity].Init(x, y, rotation, scale);
 }
 
-void InitSprite(EntityID entity, Texture* texture) {
-    SpriteComponent* sprite = 
-        (SpriteComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_SPRITE);
-    if (sprite) {
-        sprite->Init(texture);
-    }
+void InitSprite(EntityID entity, Texture* texture, bool isStatic) {
+    if (!g_Engine.entityManager.IsEntityValid(entity)) return;
+    g_Engine.componentArrays.sprites[entity].Init(texture, isStatic);
 }
 
 void InitWASDController(EntityID entity, float moveSpeed, bool canMove) {
     WASDControllerComponent* controller = 
-        (WASDControllerComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_WASD_CONTROLLER);
+        g_Engine.componentArrays.Find<WASDControllerComponent>(&g_Engine.entityManager, entity);
     if (controller) {
         controller->Init(moveSpeed, canMove);
     }
 }
 
 void InitCollider(EntityID entity, float width, float height, bool isStatic, bool isTrigger) {
-    ColliderComponent* collider = 
-        (ColliderComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_COLLIDER);
-    if (collider) {
-        collider->Init(width, height, isStatic, isTrigger);
-    }
+    if (!g_Engine.entityManager.IsEntityValid(entity)) return;
+    g_Engine.componentArrays.colliders[entity].Init(width, height, isStatic, isTrigger);
 } 
 
+void InitAnimation(EntityID entity, const AnimationSheet* sheet, float time, bool shouldLoop) {
+    AnimationComponent* anim = 
+        g_Engine.componentArrays.Find<AnimationComponent>(&g_Engine.entityManager, entity);
+    if (!anim) return;
+
+    anim->Init(sheet, time, shouldLoop);
+    // Show the first frame right away instead of on the first frame change
+    if (anim->playing && g_Engine.entityManager.HasComponent(entity, COMPONENT_SPRITE)) {
+        anim->ApplyTo(g_Engine.componentArrays.sprites[entity]);
+    }
+}
+
 void InitSquirrel(EntityID entity){
     SquirrelComponent* squirrel = 
-        (SquirrelComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, entity);
 
     if (squirrel){
         squirrel->Init();
@@ -77,9 +93,9 @@ void InitSquirrel(EntityID entity){
 }
 
 void InitCamera(EntityID entity, float viewportWidth, float viewportHeight, EntityID target) {
-    if (entity >= MAX_ENTITIES) return;
+    if (!g_Engine.entityManager.IsEntityValid(entity)) return;
     
-    CameraComponent* camera = (CameraComponent*) g_Engine.componentArrays.GetComponentData(entity, COMPONENT_CAMERA);
+    CameraComponent* camera = g_Engine.componentArrays.Find<CameraComponent>(&g_Engine.entityManager, entity);
     if(camera) {
         camera->Init(viewportWidth, viewportHeight, target);
         printf("Camera component initialized for entity %d\n", entity);
@@ -87,7 +103,7 @@ void InitCamera(EntityID entity, float viewportWidth, float viewportHeight, Enti
 }
 
 void InitCloud(EntityID entity, CloudType cloudType, CloudSize cloudSize){
-    CloudComponent* cloud = (CloudComponent*) g_Engine.componentArrays.GetComponentData(entity, COMPONENT_CLOUD);
+    CloudComponent* cloud = g_Engine.componentArrays.Find<CloudComponent>(&g_Engine.entityManager, entity);
 
     if (cloud){
         cloud->Init(cloudType, cloudSize);
@@ -96,7 +112,7 @@ void InitCloud(EntityID entity, CloudType cloudType, CloudSize cloudSize){
 
 void InitPeanut(EntityID entity, PeanutType type) {
     PeanutComponent* peanut = 
-        (PeanutComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_PEANUT);
+        g_Engine.componentArrays.Find<PeanutComponent>(&g_Engine.entityManager, entity);
     
     if (peanut) {
         peanut->Init(type);
@@ -1,11 +1,15 @@
 #pragma once
 #include "ecs_types.h"
+#include "paged_array.h"
+#include "entity.h"
 #include "../resource_manager.h"
+#include "../render_queue.h"
 #include "components/squirrel_components.h"
 #include "string.h"
 #include "stdio.h"
-#include "base_component.h"
 #include <float.h>
+#include <math.h>
+#include <utility>
 #include "components/cloud_components.h"
 #include "components/background_component.h"
 #include "components/peanut_components.h"
@@ -15,67 +19,213 @@
 #define CAMERA_DEADZONE_X 100.0f     // Horizontal deadzone before camera starts moving
 #define CAMERA_DEADZONE_Y 100.0f     // Vertical deadzone before camera starts moving
 
-struct TransformComponent : Component {
+// Transform, sprite and collider are the hot components, most systems walk
+// them every step. They are stored as structure of arrays: one contiguous
+// array per field, so a loop that only reads x/y only pulls x/y into cache
+// and can be vectorized.
+//
+// The *Component structs are plain values (prefab defaults, copies). Indexing
+// a *Store gives a *Ref: references into each field array with the same field
+// names and methods, so ref->x reads like the old pointer code and compiles
+// down to a direct array access.
+
+struct TransformComponent {
     float x, y;
     float rotation;
     float scale;
+    float prevX, prevY;
+    float prevRotation;
 
     void Init(float posX, float posY, float rot = 0.0f, float scl = 1.0f) {
         x = posX;
         y = posY;
         rotation = rot;
         scale = scl;
+        prevX = x;
+        prevY = y;
+        prevRotation = rotation;
+    }
+};
+
+struct TransformRef {
+    float& x;
+    float& y;
+    float& rotation;
+    float& scale;
+
+    // State at the start of the last fixed step, rendering blends towards x/y
+    float& prevX;
+    float& prevY;
+    float& prevRotation;
+
+    TransformRef* operator->() { return this; }
+
+    void operator=(const TransformComponent& value) {
+        x = value.x;
+        y = value.y;
+        rotation = value.rotation;
+        scale = value.scale;
+        prevX = value.prevX;
+        prevY = value.prevY;
+        prevRotation = value.prevRotation;
+    }
+
+    void Init(float posX, float posY, float rot = 0.0f, float scl = 1.0f) {
+        TransformComponent value;
+        value.Init(posX, posY, rot, scl);
+        *this = value;
+    }
+
+    void SavePrevious() {
+        prevX = x;
+        prevY = y;
+        prevRotation = rotation;
+    }
+
+    // Position/rotation between the last two fixed steps (alpha 0..1)
+    float InterpolatedX(float alpha) const { return prevX + (x - prevX) * alpha; }
+    float InterpolatedY(float alpha) const { return prevY + (y - prevY) * alpha; }
+    float InterpolatedRotation(float alpha) const {
+        // Take the short way around so the arrow doesn't spin at +-180
+        float delta = fmodf(rotation - prevRotation + 540.0f, 360.0f) - 180.0f;
+        return prevRotation + delta * alpha;
+    }
+
+    void Destroy() {
+        Init(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+};
+
+// Field arrays for one page of entities
+struct TransformPage {
+    float x[COMPONENT_PAGE_SIZE];
+    float y[COMPONENT_PAGE_SIZE];
+    float rotation[COMPONENT_PAGE_SIZE];
+    float scale[COMPONENT_PAGE_SIZE];
+    float prevX[COMPONENT_PAGE_SIZE];
+    float prevY[COMPONENT_PAGE_SIZE];
+    float prevRotation[COMPONENT_PAGE_SIZE];
+};
+
+struct TransformStore {
+    PageTable<TransformPage> table;
+
+    void Destroy() { table.Destroy(); }
+    size_t AllocatedBytes() const { return table.AllocatedBytes(); }
+
+    TransformRef operator[](EntityID entity) {
+        TransformPage* page = table.GetPage(entity);
+        uint32_t i = entity & COMPONENT_PAGE_MASK;
+        return { page->x[i], page->y[i], page->rotation[i], page->scale[i],
+                 page->prevX[i], page->prevY[i], page->prevRotation[i] };
     }
 
-    void Destroy() override {
-        x = 0.0f;
-        y = 0.0f;
-        rotation = 0.0f;
-        scale = 1.0f;
+    // SavePrevious for every slot at once, three straight array copies per
+    // page. Unused slots get copied too, which is cheaper than skipping them.
+    void SavePreviousAll() {
+        for (int p = 0; p < MAX_COMPONENT_PAGES; p++) {
+            TransformPage* page = table.pages[p];
+            if (!page) continue;
+            memcpy(page->prevX, page->x, sizeof(page->x));
+            memcpy(page->prevY, page->y, sizeof(page->y));
+            memcpy(page->prevRotation, page->rotation, sizeof(page->rotation));
+        }
     }
 };
 
-struct SpriteComponent : Component {
+struct SpriteComponent {
     Texture* texture;
     int width, height;
     SDL_Rect srcRect;
     bool isVisible;
+    bool isStatic;
+    RenderLayer layer;
 
-    void Init(Texture* tex) {
+    void Init(Texture* tex, bool staticSprite = false) {
         texture = tex;
+        isStatic = staticSprite;
+        layer = RENDER_LAYER_WORLD;
         if (texture) {
             width = texture->width;
             height = texture->height;
-            srcRect = {0, 0, width, height};
+            srcRect = texture->atlasRect;
             isVisible = true;
         } else {
-            texture = nullptr;
             width = 0;
             height = 0;
             srcRect = {0, 0, 0, 0};
             isVisible = false;
         }
     }
+};
+
+struct SpriteRef {
+    Texture*& texture;
+    int& width;
+    int& height;
+    SDL_Rect& srcRect;
+    bool& isVisible;
+    bool& isStatic;  // Never moves, lets the renderer keep it in its culling grid
+    RenderLayer& layer;
+
+    SpriteRef* operator->() { return this; }
+
+    void operator=(const SpriteComponent& value) {
+        texture = value.texture;
+        width = value.width;
+        height = value.height;
+        srcRect = value.srcRect;
+        isVisible = value.isVisible;
+        isStatic = value.isStatic;
+        layer = value.layer;
+    }
+
+    void Init(Texture* tex, bool staticSprite = false) {
+        SpriteComponent value;
+        value.Init(tex, staticSprite);
+        *this = value;
+    }
 
     void ChangeTexture(Texture* newTexture) {
         texture = newTexture;
         if (texture) {
             width = texture->width;
             height = texture->height;
-            srcRect = {0, 0, width, height};
+            srcRect = texture->atlasRect;
         }
     }
 
-    void Destroy() override {
+    void Destroy() {
         // Note: We don't destroy the texture here as it's managed by ResourceManager
-        texture = nullptr;
-        width = 0;
-        height = 0;
-        srcRect = {0, 0, 0, 0};
+        Init(nullptr);
+    }
+};
+
+struct SpritePage {
+    Texture* texture[COMPONENT_PAGE_SIZE];
+    int width[COMPONENT_PAGE_SIZE];
+    int height[COMPONENT_PAGE_SIZE];
+    SDL_Rect srcRect[COMPONENT_PAGE_SIZE];
+    bool isVisible[COMPONENT_PAGE_SIZE];
+    bool isStatic[COMPONENT_PAGE_SIZE];
+    RenderLayer layer[COMPONENT_PAGE_SIZE];
+};
+
+struct SpriteStore {
+    PageTable<SpritePage> table;
+
+    void Destroy() { table.Destroy(); }
+    size_t AllocatedBytes() const { return table.AllocatedBytes(); }
+
+    SpriteRef operator[](EntityID entity) {
+        SpritePage* page = table.GetPage(entity);
+        uint32_t i = entity & COMPONENT_PAGE_MASK;
+        return { page->texture[i], page->width[i], page->height[i], page->srcRect[i],
+                 page->isVisible[i], page->isStatic[i], page->layer[i] };
     }
 };
 
-struct WASDControllerComponent : Component {
+struct WASDControllerComponent {
     float moveSpeed;
     bool canMove;
 
@@ -84,72 +234,102 @@ struct WASDControllerComponent : Component {
         canMove = enabled;
     }
 
-    void Destroy() override {
+    void Destroy() {
         moveSpeed = 0.0f;
         canMove = false;
     }
 };
 
-struct ColliderComponent : Component {
+struct ColliderComponent {
     float width;
     float height;
-    bool isTrigger;  // If true, detects collision but doesn't prevent movement
-    bool isStatic;   // If true, this object won't be moved during collision resolution
-    
+    bool isTrigger;
+    bool isStatic;
+
     void Init(float w, float h, bool staticCollider = false, bool triggerCollider = false) {
         width = w;
         height = h;
         isStatic = staticCollider;
         isTrigger = triggerCollider;
     }
-    
-    void Destroy() override {
-        width = 0.0f;
-        height = 0.0f;
-        isTrigger = false;
-        isStatic = false;
+};
+
+struct ColliderRef {
+    float& width;
+    float& height;
+    bool& isTrigger;  // If true, detects collision but doesn't prevent movement
+    bool& isStatic;   // If true, this object won't be moved during collision resolution
+
+    ColliderRef* operator->() { return this; }
+
+    void operator=(const ColliderComponent& value) {
+        width = value.width;
+        height = value.height;
+        isTrigger = value.isTrigger;
+        isStatic = value.isStatic;
+    }
+
+    void Init(float w, float h, bool staticCollider = false, bool triggerCollider = false) {
+        ColliderComponent value;
+        value.Init(w, h, staticCollider, triggerCollider);
+        *this = value;
+    }
+
+    void Destroy() {
+        Init(0.0f, 0.0f);
     }
 };
 
-struct AnimationComponent : Component {
-    Texture* spriteSheet;            // The sprite sheet texture
-    SDL_Rect frameRect;             // Current frame rectangle
-    int frameWidth;                 // Width of each frame
-    int frameHeight;                // Height of each frame
-    int columns;                    // Number of columns in sheet
-    int totalFrames;                // Total number of frames
-    
+struct ColliderPage {
+    float width[COMPONENT_PAGE_SIZE];
+    float height[COMPONENT_PAGE_SIZE];
+    bool isTrigger[COMPONENT_PAGE_SIZE];
+    bool isStatic[COMPONENT_PAGE_SIZE];
+};
+
+struct ColliderStore {
+    PageTable<ColliderPage> table;
+
+    void Destroy() { table.Destroy(); }
+    size_t AllocatedBytes() const { return table.AllocatedBytes(); }
+
+    ColliderRef operator[](EntityID entity) {
+        ColliderPage* page = table.GetPage(entity);
+        uint32_t i = entity & COMPONENT_PAGE_MASK;
+        return { page->width[i], page->height[i], page->isTrigger[i], page->isStatic[i] };
+    }
+};
+
+#define MAX_ANIMATION_FRAMES 32
+
+// Every frame of one animation, worked out once when the sheet is made (see
+// AnimationSheets) so advancing an animation is just an index bump. Frames can
+// come from a grid inside one texture or from separate textures.
+struct AnimationSheet {
+    Texture* textures[MAX_ANIMATION_FRAMES];  // Texture each frame is drawn from
+    SDL_Rect frames[MAX_ANIMATION_FRAMES];    // Frame rect inside that texture's atlas page
+    int frameCount;
+};
+
+struct AnimationComponent {
+    const AnimationSheet* sheet;    // Shared frame table
     int currentFrame;               // Current frame index
     float frameTime;                // Time per frame (in seconds)
     float accumulator;              // Time accumulator for animation
     bool playing;                   // Is animation playing?
     bool loop;                      // Should animation loop?
 
-    void Init(Texture* sheet, int frameW, int frameH, int cols, int frames, 
-              float time = 0.1f, bool shouldLoop = true) {
-        spriteSheet = sheet;
-        frameWidth = frameW;
-        frameHeight = frameH;
-        columns = cols;
-        totalFrames = frames;
-        
+    void Init(const AnimationSheet* animSheet, float time = 0.1f, bool shouldLoop = true) {
+        sheet = animSheet;
         currentFrame = 0;
         frameTime = time;
         accumulator = 0.0f;
-        playing = true;
+        playing = sheet && sheet->frameCount > 0 && frameTime > 0.0f;
         loop = shouldLoop;
-
-        // Initialize first frame rectangle
-        UpdateFrameRect();
     }
 
-    void Destroy() override {
-        spriteSheet = nullptr;
-        frameRect = {0, 0, 0, 0};
-        frameWidth = 0;
-        frameHeight = 0;
-        columns = 0;
-        totalFrames = 0;
+    void Destroy() {
+        sheet = nullptr;
         currentFrame = 0;
         frameTime = 0.0f;
         accumulator = 0.0f;
@@ -157,15 +337,16 @@ struct AnimationComponent : Component {
         loop = false;
     }
 
-    void UpdateFrameRect() {
-        frameRect.x = currentFrame % columns * frameWidth;
-        frameRect.y = currentFrame / columns * frameHeight;
-        frameRect.w = frameWidth;
-        frameRect.h = frameHeight;
+    // Points the sprite at the current frame, the renderer takes it from there
+    void ApplyTo(SpriteRef sprite) const {
+        sprite->texture = sheet->textures[currentFrame];
+        sprite->srcRect = sheet->frames[currentFrame];
+        sprite->width = sprite->srcRect.w;
+        sprite->height = sprite->srcRect.h;
     }
 };
 
-struct GravityComponent : Component {
+struct GravityComponent {
     float velocityY;       // Current vertical velocity
     float gravityScale;    // Multiplier for gravity (1.0 = normal, 0.5 = half gravity, etc.)
     bool isGrounded;       // Is the entity touching the ground?
@@ -176,20 +357,21 @@ struct GravityComponent : Component {
         isGrounded = false;
     }
     
-    void Destroy() override {
+    void Destroy() {
         velocityY = 0.0f;
         gravityScale = 1.0f;
         isGrounded = false;
     }
 };
 
-struct CameraComponent : Component {
+struct CameraComponent {
     float x, y;              // Camera position (top-left corner)
     float targetX, targetY;  // Position camera is trying to reach
     float viewportWidth;     // Width of the camera view
     float viewportHeight;    // Height of the camera view
     EntityID targetEntity;   // Entity the camera should follow
     float cameraKick;  
+    float prevX, prevY;      // Position at the start of the last fixed step
     
     // Bounds for camera movement
     float minX, maxX;        // Horizontal bounds
@@ -197,6 +379,7 @@ struct CameraComponent : Component {
     
     void Init(float width, float height, EntityID target = 0) {
         x = y = 0.0f;
+        prevX = prevY = 0.0f;
         targetX = targetY = 0.0f;
         viewportWidth = width;
         viewportHeight = height;
@@ -210,23 +393,31 @@ struct CameraComponent : Component {
         maxY = height * 50.0f;
     }
     
-    void Destroy() override {
+    void Destroy() {
         x = y = 0.0f;
         targetX = targetY = 0.0f;
         viewportWidth = viewportHeight = 0.0f;
         targetEntity = 0;
         minX = minY = 0.0f;
         maxX = maxY = 0.0f;
+        prevX = prevY = 0.0f;
+    }
+
+    void SavePrevious() {
+        prevX = x;
+        prevY = y;
     }
+
+    float InterpolatedX(float alpha) const { return prevX + (x - prevX) * alpha; }
+    float InterpolatedY(float alpha) const { return prevY + (y - prevY) * alpha; }
 };
 
 // Component initialization functions
 void InitTransform(EntityID entity, float x, float y, float rotation = 0.0f, float scale = 1.0f);
-void InitSprite(EntityID entity, Texture* texture);
+void InitSprite(EntityID entity, Texture* texture, bool isStatic = false);
 void InitWASDController(EntityID entity, float moveSpeed = 200.0f, bool canMove = true);
 void InitCollider(EntityID entity, float width, float height, bool isStatic = false, bool isTrigger = false);
-void InitAnimation(EntityID entity, Texture* sheet, int frameW, int frameH, int cols, int frames, 
-                   float time = 0.1f, bool shouldLoop = true);
+void InitAnimation(EntityID entity, const AnimationSheet* sheet, float time = 0.1f, bool shouldLoop = true);
 void InitGravity(EntityID entity, float scale = 1.0f);
 void InitSquirrel(EntityID entity);
 void InitSquirrelPhysics(EntityID entity);
@@ -234,29 +425,91 @@ void InitCamera(EntityID entity, float width, float height, EntityID target = 0)
 void InitCloud(EntityID entity, CloudType type, CloudSize cloudSize);
 void InitPeanut(EntityID entity, PeanutType type);
 
+// Every store is paged: memory is only taken for the pages of entity IDs
+// that actually have the component
 struct ComponentArrays {
     // Component data pools
-    TransformComponent transforms[MAX_ENTITIES];
-    SpriteComponent sprites[MAX_ENTITIES];
-    WASDControllerComponent wasdControllers[MAX_ENTITIES];
-    ColliderComponent colliders[MAX_ENTITIES];
-    AnimationComponent animations[MAX_ENTITIES];
-    GravityComponent gravities[MAX_ENTITIES];
-    SquirrelComponent squirrelComponents[MAX_ENTITIES];
-    CameraComponent cameras[MAX_ENTITIES];
-    CloudComponent clouds[MAX_ENTITIES];
-    BackgroundComponent backgrounds[MAX_ENTITIES];
-    PeanutComponent peanuts[MAX_ENTITIES];
-
-    // Core functions
-    void* GetComponentData(EntityID entity, ComponentType type);
+    TransformStore transforms;
+    SpriteStore sprites;
+    PagedArray<WASDControllerComponent> wasdControllers;
+    ColliderStore colliders;
+    PagedArray<AnimationComponent> animations;
+    PagedArray<GravityComponent> gravities;
+    PagedArray<SquirrelComponent> squirrelComponents;
+    PagedArray<CameraComponent> cameras;
+    PagedArray<CloudComponent> clouds;
+    PagedArray<BackgroundComponent> backgrounds;
+    PagedArray<PeanutComponent> peanuts;
+
+    // Storage of T for an entity, picked at compile time with no lookup:
+    // T& for the whole-struct stores, TransformRef / SpriteRef / ColliderRef
+    // for the split ones. Unchecked, for IDs coming out of a view.
+    template <typename T>
+    typename ComponentTraits<T>::Ref Get(EntityID entity) {
+        return ComponentTraits<T>::Storage(this)[entity];
+    }
+
+    // Checked lookup for IDs held across frames (g_Game.squirrelEntity and
+    // such): nullptr unless the entity is alive and has a T. Whole-struct
+    // stores only, the split ones have no single struct to point at.
+    template <typename T>
+    T* Find(EntityManager* entities, EntityID entity) {
+        if (!entities->HasComponent(entity, ComponentTraits<T>::mask)) {
+            return nullptr;
+        }
+        return &ComponentTraits<T>::Storage(this)[entity];
+    }
+
+    // Resets the component's slot through the per-type reset table
     void RemoveComponent(EntityID entity, ComponentType type);
     
-    // Add this to ComponentArrays struct
     void Init() {
-        // Zero out all component arrays
+        // All page tables start out empty
         memset(this, 0, sizeof(ComponentArrays));
         
         printf("ComponentArrays initialized\n");
     }
-}; 
\ No newline at end of file
+
+    // Frees every page
+    void Destroy();
+
+    // Memory held by allocated pages, in bytes
+    size_t AllocatedBytes();
+};
+
+// Every component: its struct, its ComponentArrays member and its mask bit,
+// in bit order. Adding a component means a ComponentTypes bit, the struct,
+// a store in ComponentArrays and a line here.
+#define COMPONENT_LIST(X) \
+    X(TransformComponent,      transforms,         COMPONENT_TRANSFORM) \
+    X(SpriteComponent,         sprites,            COMPONENT_SPRITE) \
+    X(WASDControllerComponent, wasdControllers,    COMPONENT_WASD_CONTROLLER) \
+    X(ColliderComponent,       colliders,          COMPONENT_COLLIDER) \
+    X(AnimationComponent,      animations,         COMPONENT_ANIMATION) \
+    X(GravityComponent,        gravities,          COMPONENT_GRAVITY) \
+    X(SquirrelComponent,       squirrelComponents, COMPONENT_SQUIRREL) \
+    X(CameraComponent,         cameras,            COMPONENT_CAMERA) \
+    X(CloudComponent,          clouds,             COMPONENT_CLOUD) \
+    X(BackgroundComponent,     backgrounds,        COMPONENT_BACKGROUND) \
+    X(PeanutComponent,         peanuts,            COMPONENT_PEANUT)
+
+// Index of the lowest set bit, the component's type ID
+constexpr int ComponentBitIndex(ComponentType mask, int bit = 0) {
+    return (mask >> bit) & 1 ? bit : ComponentBitIndex(mask, bit + 1);
+}
+
+#define REGISTER_COMPONENT(Type, member, bit) \
+    template <> struct ComponentTraits<Type> { \
+        static const ComponentType mask = bit; \
+        static const int id = ComponentBitIndex(bit); \
+        typedef decltype(ComponentArrays::member) Store; \
+        typedef decltype(std::declval<Store&>()[EntityID()]) Ref; \
+        static Store& Storage(ComponentArrays* arrays) { return arrays->member; } \
+    };
+
+COMPONENT_LIST(REGISTER_COMPONENT)
+
+#define COUNT_COMPONENT(Type, member, bit) + 1
+static_assert(0 COMPONENT_LIST(COUNT_COMPONENT) == COMPONENT_TYPE_COUNT,
+              "COMPONENT_LIST and COMPONENT_TYPE_COUNT disagree");
+#undef COUNT_COMPONENT
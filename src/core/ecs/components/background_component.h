@@ -1,8 +1,7 @@
 #pragma once
-#include "../base_component.h"
 #include "../../engine_constants.h"
 
-struct BackgroundComponent : Component {
+struct BackgroundComponent {
     float parallaxFactor;  // How much it moves relative to camera (1.0 = full movement)
     int repeatCount;       // How many times to repeat vertically
     
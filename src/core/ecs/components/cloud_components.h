@@ -1,5 +1,4 @@
 #pragma once
-#include "../base_component.h"
 
 enum CloudType {
     CLOUD_WHITE,
@@ -12,7 +11,7 @@ enum CloudSize {
     CLOUD_SIZE_LARGE   
 };
 
-struct CloudComponent : Component {
+struct CloudComponent {
 
 #define CLOUD_BOUNCE_FORCE 300.0f
 
@@ -28,7 +27,7 @@ struct CloudComponent : Component {
         size = cloudSize;
     }
     
-    void Destroy() override {
+    void Destroy() {
         type = CLOUD_WHITE;
         isBouncy = false;
         bounceForce = 0.0f;
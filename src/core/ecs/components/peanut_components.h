@@ -1,5 +1,4 @@
 #pragma once
-#include "../base_component.h"
 #include <stdio.h>
 
 typedef enum {
@@ -12,7 +11,7 @@ typedef enum {
 #define PEANUT_SHIELD_DURATION 5.0f      // Seconds of immunity
 #define PEANUT_SUPER_DURATION 5.0f       // Seconds of super mode
 
-struct PeanutComponent : Component {
+struct PeanutComponent {
     PeanutType type;
     bool wasCollected;
 
@@ -22,7 +21,7 @@ struct PeanutComponent : Component {
         wasCollected = false;
     }
 
-    void Destroy() override {
+    void Destroy() {
         wasCollected = false;
     }
 }; 
\ No newline at end of file
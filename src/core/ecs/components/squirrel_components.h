@@ -1,7 +1,6 @@
 #ifndef SQUIRREL_COMPONENTS_H
 #define SQUIRREL_COMPONENTS_H
 
-#include "../base_component.h"
 #include <stdio.h>
  
 typedef enum {
@@ -22,8 +21,8 @@ typedef enum {
 #define SQUIRREL_WIGGLE_DURATION 1.0f // in seconds
 #define SQUIRREL_GRACE_PERIOD 3.0f // in seconds
 #define SQUIRREL_DROP_DELAY 1.0f  // Time before squirrel starts falling
-#define SMOOTHING_FACTOR 0.05f;  // Adjust this value to control smoothing (0.05-0.2 works well)
-struct SquirrelComponent : Component {
+#define SMOOTHING_FACTOR 0.05f   // Adjust this value to control smoothing (0.05-0.2 works well)
+struct SquirrelComponent {
     // Gameplay state
     SquirrelState state;
     float wiggleTimer;      // For wiggle state duration
@@ -77,7 +76,7 @@ struct SquirrelComponent : Component {
         superTimer = 0.0f;
     }
 
-    void Destroy() override {
+    void Destroy() {
         Init();
     }
 };
@@ -6,9 +6,20 @@ typedef uint32_t EntityID;
 typedef uint32_t ComponentType;
 
 // Constants
-#define MAX_ENTITIES 1000
+// An EntityID is a slot index in the low bits and that slot's generation in
+// the high bits. The generation is bumped whenever the slot is freed, so an ID
+// kept around after its entity was destroyed no longer passes IsEntityValid.
+#define ENTITY_INDEX_BITS 16
+#define MAX_ENTITIES (1 << ENTITY_INDEX_BITS)  // Upper bound on slots, storage is paged up to it
+#define ENTITY_INDEX_MASK (MAX_ENTITIES - 1)
 #define INVALID_ENTITY 0
 
+inline uint32_t EntityIndex(EntityID entity) { return entity & ENTITY_INDEX_MASK; }
+inline uint32_t EntityGeneration(EntityID entity) { return entity >> ENTITY_INDEX_BITS; }
+inline EntityID MakeEntityID(uint32_t index, uint32_t generation) {
+    return (generation << ENTITY_INDEX_BITS) | index;
+}
+
 // Component type identifiers
 enum ComponentTypes {
     COMPONENT_NONE = 0,
@@ -26,6 +37,21 @@ enum ComponentTypes {
     // Add more component types here
 }; 
 
+#define COMPONENT_TYPE_COUNT 11  // Bits used above
+
+// Compile-time description of a component type, specialized for each one by
+// REGISTER_COMPONENT in components.h: its mask bit, its bit index, and where
+// ComponentArrays keeps it.
+template <typename T> struct ComponentTraits;
+
+// Combined mask of a list of component types, ComponentMaskOf<A, B>::value
+template <typename... T> struct ComponentMaskOf {
+    static const ComponentType value = 0;
+};
+template <typename T, typename... Rest> struct ComponentMaskOf<T, Rest...> {
+    static const ComponentType value = ComponentTraits<T>::mask | ComponentMaskOf<Rest...>::value;
+};
+
 #define ADD_TRANSFORM(entity, x, y, rot, scale) \
     do { \
         g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_TRANSFORM); \
@@ -38,6 +64,13 @@ enum ComponentTypes {
         InitSprite(entity, texture); \
     } while(0)
 
+// Sprite that never moves (clouds, pickups), culled through the renderer's grid
+#define ADD_STATIC_SPRITE(entity, texture) \
+    do { \
+        g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_SPRITE); \
+        InitSprite(entity, texture, true); \
+    } while(0)
+
 #define ADD_WASD_CONTROLLER(entity, speed, enabled) \
     do { \
         g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_WASD_CONTROLLER); \
@@ -50,18 +83,18 @@ enum ComponentTypes {
         InitCollider(entity, width, height, isStatic, isTrigger); \
     } while(0)
 
-#define ADD_ANIMATION(entity, sheet, frameW, frameH, cols, frames, time, shouldLoop) \
+// Needs the sheet from AnimationSheets. Add the sprite first, the animation
+// draws through it.
+#define ADD_ANIMATION(entity, sheet, time, shouldLoop) \
     do { \
-        AnimationComponent* anim = (AnimationComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_ANIMATION); \
-        if (anim) { \
-            anim->Init(sheet, frameW, frameH, cols, frames, time, shouldLoop); \
-        } \
+        g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_ANIMATION); \
+        InitAnimation(entity, sheet, time, shouldLoop); \
     } while(0)
 
 #define ADD_GRAVITY(entity, scale) \
     do { \
         g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_GRAVITY); \
-        GravityComponent* gravity = (GravityComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_GRAVITY); \
+        GravityComponent* gravity = g_Engine.componentArrays.Find<GravityComponent>(&g_Engine.entityManager, entity); \
         if (gravity) { \
             gravity->Init(scale); \
         } \
@@ -89,7 +122,7 @@ enum ComponentTypes {
 #define ADD_BACKGROUND(entity, parallax) \
     do { \
         g_Engine.entityManager.AddComponentToEntity(entity, COMPONENT_BACKGROUND); \
-        BackgroundComponent* background = (BackgroundComponent*)g_Engine.componentArrays.GetComponentData(entity, COMPONENT_BACKGROUND); \
+        BackgroundComponent* background = g_Engine.componentArrays.Find<BackgroundComponent>(&g_Engine.entityManager, entity); \
         if (background) { \
             background->Init(parallax); \
         } \
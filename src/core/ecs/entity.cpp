@@ -4,43 +4,112 @@
 // Initialize static members if any are needed later
 EntityManager g_EntityManager;
 
+void EntityView::Init(ComponentType viewMask) {
+    mask = viewMask;
+    dense.Init();
+    sparse.Init();
+    version = 0;
+}
+
+void EntityView::Destroy() {
+    dense.Destroy();
+    sparse.Destroy();
+}
+
+bool EntityView::Contains(EntityID entity) {
+    // Untouched sparse pages mean none of their entities were ever added
+    uint32_t* slot = sparse.Find(entity);
+    return slot && *slot != 0;
+}
+
+void EntityView::Add(EntityID entity) {
+    if (Contains(entity)) return;
+
+    sparse[entity] = dense.count + 1;
+    dense.Push(entity);
+    version++;
+}
+
+void EntityView::Remove(EntityID entity) {
+    if (!Contains(entity)) return;
+
+    // Move the last entity into the hole to keep dense packed
+    uint32_t index = sparse[entity] - 1;
+    EntityID last = dense[dense.count - 1];
+    dense[index] = last;
+    sparse[last] = index + 1;
+
+    sparse[entity] = 0;
+    dense.count--;
+    version++;
+}
+
+// Pops a freed slot, or takes the next never used one. 0 when full.
+uint32_t EntityManager::AllocateIndex() {
+    if (freeIndices.count > 0) {
+        return freeIndices[--freeIndices.count];
+    }
+    // Slot 0 stays unused so INVALID_ENTITY never names a real entity
+    if (highestIndex + 1 >= MAX_ENTITIES) {
+        return 0;
+    }
+    return ++highestIndex;
+}
+
 EntityID EntityManager::CreateEntity() {
-    // Check if we've reached the entity limit
-    if (entityCount >= MAX_ENTITIES) {
+    uint32_t index = AllocateIndex();
+    if (index == 0) {
         printf("Warning: Reached maximum entity count!\n");
         return INVALID_ENTITY;
     }
-    
-    // Find first available entity ID
-    // Entity IDs start from 1 since 0 is INVALID_ENTITY
-    for (EntityID i = 1; i < MAX_ENTITIES; i++) {
-        if (!activeEntities[i]) {
-            activeEntities[i] = true;
-            componentMasks[i] = 0;
-            entityCount++;
+
+    activeEntities[index] = true;
+    componentMasks[index] = 0;
+    entityCount++;
+    return MakeEntityID(index, generations[index]);
+}
+
+int EntityManager::CreateEntities(int count, EntityID* out) {
+    for (int i = 0; i < count; i++) {
+        uint32_t index = AllocateIndex();
+        if (index == 0) {
+            printf("Warning: Reached maximum entity count, created %d of %d\n", i, count);
             return i;
         }
+
+        activeEntities[index] = true;
+        componentMasks[index] = 0;
+        out[i] = MakeEntityID(index, generations[index]);
+        entityCount++;  // Per entity, running out partway still counts the ones made
     }
-    
-    return INVALID_ENTITY;
+    return count;
 }
 
 void EntityManager::DestroyEntity(EntityID entity) {
-    if (!activeEntities[entity]) {
+    if (!IsEntityValid(entity)) {
         printf("Warning: Attempting to destroy inactive entity %u\n", entity);
         return;
     }
-    
-    activeEntities[entity] = false;
-    componentMasks[entity] = 0;
+
+    uint32_t index = EntityIndex(entity);
+    activeEntities[index] = false;
+    componentMasks[index] = 0;
+    generations[index]++;  // Wraps after 65536 reuses of the same slot
+    freeIndices.Push(index);
     entityCount--;
+
+    UpdateViews(entity);
 }
 
 bool EntityManager::IsEntityValid(EntityID entity) { 
+    uint32_t index = EntityIndex(entity);
 
-    return (entity > 0 && 
-            entity < MAX_ENTITIES && 
-            activeEntities[entity]);
+    // Above highestIndex the pages may not exist yet, nothing is alive there.
+    // A matching generation means the slot was not freed since the ID was made.
+    return (index > 0 && 
+            index <= highestIndex && 
+            activeEntities[index] &&
+            generations[index] == EntityGeneration(entity));
 }
 
 void EntityManager::AddComponentToEntity(EntityID entity, ComponentType type) {
@@ -51,6 +120,19 @@ void EntityManager::AddComponentToEntity(EntityID entity, ComponentType type) {
     
     // Add component type to entity's mask using bitwise OR
     componentMasks[entity] |= type;
+
+    UpdateViews(entity);
+}
+
+void EntityManager::AssignComponents(EntityID entity, ComponentType mask) {
+    if (!IsEntityValid(entity)) {
+        printf("Warning: Attempting to assign components to invalid entity %u\n", entity);
+        return;
+    }
+
+    componentMasks[entity] |= mask;
+
+    UpdateViews(entity);
 }
 
 void EntityManager::RemoveComponentFromEntity(EntityID entity, ComponentType type) {
@@ -65,7 +147,10 @@ void EntityManager::RemoveComponentFromEntity(EntityID entity, ComponentType typ
     // If entity has no more components, destroy it
     if (componentMasks[entity] == 0) {
         DestroyEntity(entity);
+        return;
     }
+
+    UpdateViews(entity);
 }
 
 bool EntityManager::HasComponent(EntityID entity, ComponentType componentMask) {
@@ -77,10 +162,69 @@ bool EntityManager::HasComponent(EntityID entity, ComponentType componentMask) {
     return (componentMasks[entity] & componentMask) == componentMask;
 }
 
+EntityView* EntityManager::View(ComponentType mask) {
+    SDL_AtomicLock(&viewLock);
+    for (int i = 0; i < viewCount; i++) {
+        if (views[i].mask == mask) {
+            SDL_AtomicUnlock(&viewLock);
+            return &views[i];
+        }
+    }
+
+    if (viewCount >= MAX_VIEWS) {
+        SDL_AtomicUnlock(&viewLock);
+        printf("Warning: Maximum number of entity views reached!\n");
+        return nullptr;
+    }
+
+    // New mask: build the view from the current entities once, from then on
+    // it is kept up to date by UpdateViews
+    EntityView* view = &views[viewCount++];
+    view->Init(mask);
+    for (uint32_t index = 1; index <= highestIndex; index++) {
+        if (activeEntities[index] && (componentMasks[index] & mask) == mask) {
+            view->Add(MakeEntityID(index, generations[index]));
+        }
+    }
+
+    SDL_AtomicUnlock(&viewLock);
+    return view;
+}
+
+void EntityManager::UpdateViews(EntityID entity) {
+    uint32_t entityMask = componentMasks[entity];
+    bool active = activeEntities[entity];
+
+    for (int i = 0; i < viewCount; i++) {
+        EntityView* view = &views[i];
+        if (active && (entityMask & view->mask) == view->mask) {
+            view->Add(entity);
+        } else {
+            view->Remove(entity);
+        }
+    }
+}
+
 void EntityManager::Init() {
     entityCount = 0;
-    for (EntityID i = 0; i < MAX_ENTITIES; i++) {
-        activeEntities[i] = false;
-        componentMasks[i] = 0;
+    highestIndex = 0;
+    componentMasks.Init();
+    activeEntities.Init();
+    generations.Init();
+    freeIndices.Init();
+    viewCount = 0;
+    viewLock = 0;
+}
+
+void EntityManager::Destroy() {
+    for (int i = 0; i < viewCount; i++) {
+        views[i].Destroy();
     }
-} 
\ No newline at end of file
+    viewCount = 0;
+    componentMasks.Destroy();
+    activeEntities.Destroy();
+    generations.Destroy();
+    freeIndices.Destroy();
+    entityCount = 0;
+    highestIndex = 0;
+}
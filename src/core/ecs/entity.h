@@ -1,22 +1,79 @@
 #pragma once
 #include "ecs_types.h"
+#include "paged_array.h"
+
+#define MAX_VIEWS 32
+
+// Packed list of the entities whose mask contains a given set of components.
+// Sparse set: dense holds the matching entities back to back, sparse maps an
+// entity slot to its position in dense so add/remove/contains are all O(1).
+// dense grows as entities join, sparse is paged like the component stores.
+struct EntityView {
+    ComponentType mask;
+    GrowableArray<EntityID> dense;
+    PagedArray<uint32_t> sparse;  // Slot in dense + 1, 0 if not in the view
+    uint32_t version;  // Bumped on every add/remove, lets caches detect changes
+
+    void Init(ComponentType viewMask);
+    void Destroy();
+    bool Contains(EntityID entity);
+    void Add(EntityID entity);
+    void Remove(EntityID entity);
+
+    // for (EntityID entity : *view), don't add or remove while iterating
+    EntityID* begin() { return dense.data; }
+    EntityID* end() { return dense.data + dense.count; }
+};
 
 struct EntityManager {
     // Tracks which components each entity has
-    uint32_t componentMasks[MAX_ENTITIES];
+    PagedArray<uint32_t> componentMasks;
     // Tracks which entities are active
-    bool activeEntities[MAX_ENTITIES];
+    PagedArray<bool> activeEntities;
+    // Current generation of every slot, the high bits of its live EntityID
+    PagedArray<uint16_t> generations;
+    // Slots freed by DestroyEntity, reused last in first out
+    GrowableArray<uint32_t> freeIndices;
     // Number of active entities
     uint32_t entityCount;
+    // Highest slot handed out so far, no entity above it was ever alive
+    uint32_t highestIndex;
+
+    // Views registered so far, kept in sync on every mask change
+    EntityView views[MAX_VIEWS];
+    int viewCount;
+    // Systems can ask for views from worker threads, the first request for
+    // a mask builds it under this lock
+    SDL_SpinLock viewLock;
     
     // Core functions
     EntityID CreateEntity();
+    // Creates up to count entities into out, returns how many were made
+    int CreateEntities(int count, EntityID* out);
     void DestroyEntity(EntityID entity);
     bool IsEntityValid(EntityID entity);
     
     // Component relationship functions
     void AddComponentToEntity(EntityID entity, ComponentType type);
+    // Adds several components at once, views are only updated a single time
+    void AssignComponents(EntityID entity, ComponentType mask);
     void RemoveComponentFromEntity(EntityID entity, ComponentType type);
     bool HasComponent(EntityID entity, ComponentType type);
+
+    // Returns the packed list of entities having all components in mask.
+    // The first call for a mask builds the view, later calls just look it up.
+    EntityView* View(ComponentType mask);
+
+    // Same, with the mask built at compile time: View<TransformComponent, GravityComponent>()
+    template <typename... T>
+    EntityView* View() {
+        return View(ComponentMaskOf<T...>::value);
+    }
+
     void Init();
-};
\ No newline at end of file
+    void Destroy();
+
+private:
+    uint32_t AllocateIndex();
+    void UpdateViews(EntityID entity);
+};
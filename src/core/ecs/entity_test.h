@@ -35,8 +35,11 @@ inline void TestEntityManager(){
     // Test 4: Create entity after destruction
     printf("\nTest 4: Creating new entity after destruction\n");
     EntityID entity4 = manager.CreateEntity();
-    printf("New entity created: %u\n", entity4);
+    printf("New entity created: %u (slot %u, generation %u)\n",
+           entity4, EntityIndex(entity4), EntityGeneration(entity4));
     printf("Entity count: %u\n", manager.entityCount);
+    printf("Old entity %u valid after slot reuse (expect no): %s\n", entity2, manager.IsEntityValid(entity2) ? "yes" : "no");
+    printf("New entity %u valid (expect yes): %s\n", entity4, manager.IsEntityValid(entity4) ? "yes" : "no");
     
     // Test 5: Debug print active entities
     printf("\nTest 5: Active entities status:\n");
@@ -46,5 +49,54 @@ inline void TestEntityManager(){
                manager.activeEntities[i], 
                manager.componentMasks[i]);
     }
+
+    // Test 6: Views follow component changes
+    printf("\nTest 6: Entity views\n");
+    EntityView* view = manager.View(COMPONENT_TRANSFORM | COMPONENT_SPRITE);
+    manager.AddComponentToEntity(entity1, COMPONENT_TRANSFORM);
+    manager.AddComponentToEntity(entity1, COMPONENT_SPRITE);
+    manager.AddComponentToEntity(entity3, COMPONENT_TRANSFORM);
+    printf("View count after adds (expect 1): %u\n", view->dense.count);
+    manager.AddComponentToEntity(entity3, COMPONENT_SPRITE);
+    printf("View count after entity %u gets a sprite (expect 2): %u\n", entity3, view->dense.count);
+    manager.RemoveComponentFromEntity(entity1, COMPONENT_SPRITE);
+    printf("View count after removing sprite (expect 1): %u, first = %u\n", view->dense.count, view->dense[0]);
+    manager.DestroyEntity(entity3);
+    printf("View count after destroy (expect 0): %u\n", view->dense.count);
+
+    // Test 7: Storage grows past the first page
+    printf("\nTest 7: Paged growth\n");
+    for (int i = 0; i < 5000; i++) {
+        EntityID entity = manager.CreateEntity();
+        manager.AddComponentToEntity(entity, COMPONENT_TRANSFORM | COMPONENT_SPRITE);
+    }
+    printf("Entity count (expect 5002): %u\n", manager.entityCount);
+    printf("View count (expect 5000): %u\n", view->dense.count);
+    printf("Mask pages allocated (expect 5): %d\n", manager.componentMasks.table.allocatedPages);
+
+    // Test 8: Bulk creation reuses freed slots first
+    printf("\nTest 8: Bulk creation\n");
+    manager.DestroyEntity(entity1);
+    manager.DestroyEntity(entity4);
+    EntityID bulk[4];
+    int created = manager.CreateEntities(4, bulk);
+    printf("Created %d entities, slots %u %u %u %u (expect 2 1 then two new)\n", created,
+           EntityIndex(bulk[0]), EntityIndex(bulk[1]), EntityIndex(bulk[2]), EntityIndex(bulk[3]));
+    printf("Entity count (expect 5004): %u\n", manager.entityCount);
+    printf("Destroying stale entity %u (expect a warning):\n", entity1);
+    manager.DestroyEntity(entity1);
+    printf("Entity count unchanged (expect 5004): %u\n", manager.entityCount);
+
+    // Running out of slots partway keeps the ones that were made, and counted
+    static EntityID rest[MAX_ENTITIES];
+    created = manager.CreateEntities(MAX_ENTITIES, rest);
+    printf("Created %d of %d (expect %d, with a warning)\n", created, MAX_ENTITIES, MAX_ENTITIES - 1 - 5004);
+    printf("Entity count when full (expect %d): %u\n", MAX_ENTITIES - 1, manager.entityCount);
+    for (int i = 0; i < created; i++) {
+        manager.DestroyEntity(rest[i]);
+    }
+    printf("Entity count after destroying them (expect 5004): %u\n", manager.entityCount);
+
+    manager.Destroy();
 }
 #endif // ENTITY_TEST_H 
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+#include "ecs_types.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Per-entity storage is split into pages of COMPONENT_PAGE_SIZE entities
+#define COMPONENT_PAGE_SHIFT 10
+#define COMPONENT_PAGE_SIZE (1 << COMPONENT_PAGE_SHIFT)
+#define COMPONENT_PAGE_MASK (COMPONENT_PAGE_SIZE - 1)
+#define MAX_COMPONENT_PAGES (MAX_ENTITIES >> COMPONENT_PAGE_SHIFT)
+
+// Page table for one kind of per-entity data. Page n covers entity slots
+// n * COMPONENT_PAGE_SIZE up to the next page, and is allocated (zeroed) the
+// first time one of them is touched. Lookups ignore the generation bits, so
+// any ID for a slot finds the same storage. Pages never move once allocated, so
+// references into them stay valid while the store grows. A component type no
+// entity uses never allocates anything.
+template <typename Page>
+struct PageTable {
+    Page* pages[MAX_COMPONENT_PAGES];
+    int allocatedPages;
+
+    void Init() {
+        memset(pages, 0, sizeof(pages));
+        allocatedPages = 0;
+    }
+
+    void Destroy() {
+        for (int i = 0; i < MAX_COMPONENT_PAGES; i++) {
+            delete pages[i];
+        }
+        Init();
+    }
+
+    Page* GetPage(EntityID entity) {
+        uint32_t pageIndex = EntityIndex(entity) >> COMPONENT_PAGE_SHIFT;
+        Page* page = pages[pageIndex];
+        if (!page) {
+            page = new Page();  // Value-initialized, so zeroed
+            pages[pageIndex] = page;
+            allocatedPages++;
+        }
+        return page;
+    }
+
+    // Like GetPage but never allocates, nullptr if the page is still untouched
+    Page* FindPage(EntityID entity) const {
+        return pages[EntityIndex(entity) >> COMPONENT_PAGE_SHIFT];
+    }
+
+    size_t AllocatedBytes() const {
+        return (size_t)allocatedPages * sizeof(Page);
+    }
+};
+
+template <typename T>
+struct ComponentPage {
+    T items[COMPONENT_PAGE_SIZE];
+};
+
+// Paged array of one component struct, indexed by entity like a plain array
+template <typename T>
+struct PagedArray {
+    PageTable< ComponentPage<T> > table;
+
+    void Init() { table.Init(); }
+    void Destroy() { table.Destroy(); }
+    size_t AllocatedBytes() const { return table.AllocatedBytes(); }
+
+    T& operator[](EntityID entity) {
+        return table.GetPage(entity)->items[entity & COMPONENT_PAGE_MASK];
+    }
+
+    // nullptr if the entity's page was never touched
+    T* Find(EntityID entity) const {
+        ComponentPage<T>* page = table.FindPage(entity);
+        return page ? &page->items[entity & COMPONENT_PAGE_MASK] : nullptr;
+    }
+};
+
+// Contiguous list that doubles when full, for packed entity lists that get
+// iterated front to back. Elements move when it grows, so keep indices into
+// it rather than pointers. Only for plain data, it is grown with realloc.
+template <typename T>
+struct GrowableArray {
+    T* data;
+    uint32_t count;
+    uint32_t capacity;
+
+    void Init() {
+        data = nullptr;
+        count = 0;
+        capacity = 0;
+    }
+
+    void Destroy() {
+        free(data);
+        Init();
+    }
+
+    void Reserve(uint32_t size) {
+        if (size <= capacity) return;
+
+        uint32_t newCapacity = capacity ? capacity : 64;
+        while (newCapacity < size) {
+            newCapacity *= 2;
+        }
+        data = (T*)realloc(data, newCapacity * sizeof(T));
+        capacity = newCapacity;
+    }
+
+    void Push(const T& value) {
+        if (count == capacity) {
+            Reserve(count + 1);
+        }
+        data[count++] = value;
+    }
+
+    void Clear() { count = 0; }
+
+    T& operator[](uint32_t index) { return data[index]; }
+};
@@ -0,0 +1,60 @@
+#include "prefab.h"
+#include "../engine.h"
+
+void Prefab::Init(ComponentType prefabMask) {
+    if (prefabMask & ~PREFAB_COMPONENTS) {
+        printf("Warning: Prefab mask %u has components without defaults\n", prefabMask);
+    }
+    mask = prefabMask & PREFAB_COMPONENTS;
+    transform.Init(0.0f, 0.0f, 0.0f, 1.0f);
+    sprite.Init(nullptr);
+    collider.Init(0.0f, 0.0f);
+    cloud.Init(CLOUD_WHITE, CLOUD_SIZE_SMALL);
+    peanut.Init(PEANUT_TYPE_REGULAR);
+}
+
+#define SPAWN_CHUNK 256  // IDs allocated per CreateEntities call
+
+int SpawnBatch(const Prefab* prefab, const SDL_FPoint* positions, int count, EntityID* spawned) {
+    EntityManager* entities = &g_Engine.entityManager;
+    ComponentArrays* components = &g_Engine.componentArrays;
+    ComponentType mask = prefab->mask;
+
+    EntityID batch[SPAWN_CHUNK];
+    int batchStart = 0;
+    int batchCount = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (i == batchStart + batchCount) {
+            int wanted = count - i < SPAWN_CHUNK ? count - i : SPAWN_CHUNK;
+            batchStart = i;
+            batchCount = entities->CreateEntities(wanted, batch);
+            if (batchCount == 0) {
+                return i;
+            }
+        }
+        EntityID entity = batch[i - batchStart];
+
+        // Plain struct copies, no per-component lookups or Init calls
+        if (mask & COMPONENT_TRANSFORM) {
+            TransformRef transform = components->transforms[entity];
+            transform = prefab->transform;
+            transform->x = positions[i].x;
+            transform->y = positions[i].y;
+            transform->SavePrevious();
+        }
+        if (mask & COMPONENT_SPRITE)   components->sprites[entity] = prefab->sprite;
+        if (mask & COMPONENT_COLLIDER) components->colliders[entity] = prefab->collider;
+        if (mask & COMPONENT_CLOUD)    components->clouds[entity] = prefab->cloud;
+        if (mask & COMPONENT_PEANUT)   components->peanuts[entity] = prefab->peanut;
+
+        // Components are in place, now the views can pick the entity up
+        entities->AssignComponents(entity, mask);
+
+        if (spawned) {
+            spawned[i] = entity;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "components.h"
+
+// Template for a kind of entity that gets spawned many times (clouds, peanuts).
+// The mask and component defaults are set up once, SpawnBatch then stamps
+// copies out with only the position changing per entity.
+// Components a prefab can carry defaults for
+#define PREFAB_COMPONENTS (COMPONENT_TRANSFORM | COMPONENT_SPRITE | COMPONENT_COLLIDER | \
+                           COMPONENT_CLOUD | COMPONENT_PEANUT)
+
+struct Prefab {
+    ComponentType mask;
+
+    // Default values, only the ones in mask are used
+    TransformComponent transform;
+    SpriteComponent sprite;
+    ColliderComponent collider;
+    CloudComponent cloud;
+    PeanutComponent peanut;
+
+    void Init(ComponentType prefabMask);
+};
+
+// Creates one entity per position, copies the prefab's components into the
+// arrays and assigns the whole mask in one go. Spawned IDs are written to
+// spawned if given. Returns how many entities were created.
+int SpawnBatch(const Prefab* prefab, const SDL_FPoint* positions, int count, EntityID* spawned = nullptr);
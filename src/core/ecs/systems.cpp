@@ -1,14 +1,17 @@
 #include "systems.h"
 #include <stdio.h>
+#include "../profiler.h"
 
 void SystemManager::Init() {
     systemCount = 0;
     for (int i = 0; i < MAX_SYSTEMS; i++) {
         systems[i] = nullptr;
     }
+    graphDirty = true;
+    SDL_AtomicSet(&stepCounter.pending, 0);
 }
 
-void SystemManager::RegisterSystem(System* system) {
+void SystemManager::RegisterSystem(System* system, SystemPhase phase, const char* name) {
     if (systemCount >= MAX_SYSTEMS) {
         printf("Warning: Maximum number of systems reached!\n");
         return;
@@ -16,8 +19,12 @@ void SystemManager::RegisterSystem(System* system) {
 
     if (system) {
         systems[systemCount] = system;
+        phases[systemCount] = phase;
+        names[systemCount] = name;
+        profileZones[systemCount] = Profiler::RegisterZone(name);
         system->Init();
         systemCount++;
+        graphDirty = true;
     }
 }
 
@@ -31,18 +38,94 @@ void SystemManager::UnregisterSystem(System* system) {
             // Shift remaining systems down
             for (int j = i; j < systemCount - 1; j++) {
                 systems[j] = systems[j + 1];
+                phases[j] = phases[j + 1];
+                names[j] = names[j + 1];
+                profileZones[j] = profileZones[j + 1];
             }
             
             systemCount--;
             systems[systemCount] = nullptr;
+            graphDirty = true;
             return;
         }
     }
 }
 
-void SystemManager::UpdateSystems(float deltaTime, EntityManager* entities, ComponentArrays* components) {
+bool SystemManager::Conflicts(const System* a, const System* b) {
+    if (!a->accessDeclared || !b->accessDeclared) return true;
+    return (a->writes & (b->reads | b->writes)) != 0 || (b->writes & a->reads) != 0;
+}
+
+void SystemManager::BuildGraph() {
     for (int i = 0; i < systemCount; i++) {
-        if (systems[i]) {
+        dependents[i] = 0;
+        dependencyCount[i] = 0;
+        jobs[i].manager = this;
+        jobs[i].index = i;
+    }
+
+    for (int j = 0; j < systemCount; j++) {
+        if (phases[j] != SYSTEM_PHASE_FIXED) continue;
+        for (int i = 0; i < j; i++) {
+            if (phases[i] != SYSTEM_PHASE_FIXED) continue;
+            if (Conflicts(systems[i], systems[j])) {
+                dependents[i] |= 1u << j;
+                dependencyCount[j]++;
+            }
+        }
+    }
+    graphDirty = false;
+}
+
+void SystemManager::RunSystemJob(void* data) {
+    SystemJob* job = (SystemJob*)data;
+    SystemManager* manager = job->manager;
+    int i = job->index;
+
+    {
+        ProfileScope scope(manager->profileZones[i]);
+        manager->systems[i]->Update(manager->stepDeltaTime, manager->stepEntities, manager->stepComponents);
+    }
+
+    // Release the systems that were only waiting for this one. Submitted
+    // before this job counts as done, so the step can't finish early.
+    for (int d = i + 1; d < manager->systemCount; d++) {
+        if (!(manager->dependents[i] & (1u << d))) continue;
+        if (SDL_AtomicAdd(&manager->waitingOn[d], -1) == 1) {
+            JobSystem::Submit(RunSystemJob, &manager->jobs[d], &manager->stepCounter);
+        }
+    }
+}
+
+void SystemManager::RunScheduled(float deltaTime, EntityManager* entities, ComponentArrays* components) {
+    if (graphDirty) {
+        BuildGraph();
+    }
+
+    stepDeltaTime = deltaTime;
+    stepEntities = entities;
+    stepComponents = components;
+
+    for (int i = 0; i < systemCount; i++) {
+        SDL_AtomicSet(&waitingOn[i], dependencyCount[i]);
+    }
+    for (int i = 0; i < systemCount; i++) {
+        if (systems[i] && phases[i] == SYSTEM_PHASE_FIXED && dependencyCount[i] == 0) {
+            JobSystem::Submit(RunSystemJob, &jobs[i], &stepCounter);
+        }
+    }
+    JobSystem::Wait(&stepCounter);
+}
+
+void SystemManager::UpdateSystems(SystemPhase phase, float deltaTime, EntityManager* entities, ComponentArrays* components) {
+    if (phase == SYSTEM_PHASE_FIXED && JobSystem::WorkerCount() > 0) {
+        RunScheduled(deltaTime, entities, components);
+        return;
+    }
+
+    for (int i = 0; i < systemCount; i++) {
+        if (systems[i] && phases[i] == phase) {
+            ProfileScope scope(profileZones[i]);
             systems[i]->Update(deltaTime, entities, components);
         }
     }
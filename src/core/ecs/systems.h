@@ -1,21 +1,85 @@
 #pragma once
 #include "components.h"
 #include "entity.h"
+#include "../job_system.h"
+
+// Fixed systems advance the simulation at FIXED_TIMESTEP, render systems run
+// once per displayed frame
+enum SystemPhase {
+    SYSTEM_PHASE_FIXED = 0,
+    SYSTEM_PHASE_RENDER,
+    SYSTEM_PHASE_COUNT
+};
+
+// State outside the component stores that systems share, declared next to
+// component masks so the scheduler orders systems touching the same thing.
+// Kept above the component bits.
+#define SYSTEM_RESOURCE_AUDIO      (1u << 24)  // Sound playback through ResourceManager
+#define SYSTEM_RESOURCE_GAME_STATE (1u << 25)  // Fields of g_Game
+#define SYSTEM_RESOURCE_ENTITIES   (1u << 26)  // Creating/destroying entities, changing masks
 
 struct System {
+    // Component types and SYSTEM_RESOURCE_ bits Update reads and writes,
+    // writing implies reading. A system that never declares runs alone.
+    ComponentType reads = 0;
+    ComponentType writes = 0;
+    bool accessDeclared = false;
+
+    void DeclareAccess(ComponentType readMask, ComponentType writeMask) {
+        reads = readMask;
+        writes = writeMask;
+        accessDeclared = true;
+    }
+
     virtual void Init() = 0;
     virtual void Update(float deltaTime, EntityManager* entities, ComponentArrays* components) = 0;
     virtual void Destroy() = 0;
 };
 
+struct SystemManager;
+
+// Job data for running one system of the scheduled phase
+struct SystemJob {
+    SystemManager* manager;
+    int index;
+};
+
 struct SystemManager {
     static const int MAX_SYSTEMS = 32;
     System* systems[MAX_SYSTEMS];
+    SystemPhase phases[MAX_SYSTEMS];
+    const char* names[MAX_SYSTEMS];
+    int profileZones[MAX_SYSTEMS];
     int systemCount;
+
+    // Dependency graph of the fixed phase. A system waits for every earlier
+    // registered one it conflicts with (one writes what the other touches),
+    // so any order the graph allows gives the same result as running them
+    // one by one. dependents is a bit per system index.
+    uint32_t dependents[MAX_SYSTEMS];
+    int dependencyCount[MAX_SYSTEMS];
+    bool graphDirty;
+
+    // State of the fixed step being run on the job system
+    SystemJob jobs[MAX_SYSTEMS];
+    SDL_atomic_t waitingOn[MAX_SYSTEMS];
+    JobCounter stepCounter;
+    float stepDeltaTime;
+    EntityManager* stepEntities;
+    ComponentArrays* stepComponents;
     
     void Init();
-    void RegisterSystem(System* system);
+    void RegisterSystem(System* system, SystemPhase phase = SYSTEM_PHASE_FIXED, const char* name = "System");
     void UnregisterSystem(System* system);
-    void UpdateSystems(float deltaTime, EntityManager* entities, ComponentArrays* components);
+    // Fixed systems run in parallel where the graph allows when there are
+    // worker threads. Render systems always run in order on the calling
+    // (main) thread, they own the renderer.
+    void UpdateSystems(SystemPhase phase, float deltaTime, EntityManager* entities, ComponentArrays* components);
     void Destroy();
+
+private:
+    void BuildGraph();
+    void RunScheduled(float deltaTime, EntityManager* entities, ComponentArrays* components);
+    static bool Conflicts(const System* a, const System* b);
+    static void RunSystemJob(void* data);
 }; 
\ No newline at end of file
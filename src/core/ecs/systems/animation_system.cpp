@@ -0,0 +1,98 @@
+#include "animation_system.h"
+#include <stdio.h>
+
+AnimationSheet AnimationSheets::sheets[MAX_ANIMATION_SHEETS];
+int AnimationSheets::sheetCount = 0;
+
+AnimationSheet* AnimationSheets::NewSheet(int frameCount) {
+    if (sheetCount >= MAX_ANIMATION_SHEETS) {
+        printf("Warning: Maximum number of animation sheets reached!\n");
+        return nullptr;
+    }
+    if (frameCount <= 0 || frameCount > MAX_ANIMATION_FRAMES) {
+        printf("Warning: Animation sheet needs 1 to %d frames, got %d\n", MAX_ANIMATION_FRAMES, frameCount);
+        return nullptr;
+    }
+
+    AnimationSheet* sheet = &sheets[sheetCount++];
+    sheet->frameCount = frameCount;
+    return sheet;
+}
+
+const AnimationSheet* AnimationSheets::FromGrid(Texture* texture, int frameWidth, int frameHeight,
+                                                int columns, int frameCount) {
+    if (!texture || columns <= 0) return nullptr;
+
+    AnimationSheet* sheet = NewSheet(frameCount);
+    if (!sheet) return nullptr;
+
+    // The div/mod happens here once instead of on every frame change.
+    // Frames are laid out inside the sheet's spot in the atlas.
+    for (int i = 0; i < frameCount; i++) {
+        sheet->textures[i] = texture;
+        sheet->frames[i].x = texture->atlasRect.x + i % columns * frameWidth;
+        sheet->frames[i].y = texture->atlasRect.y + i / columns * frameHeight;
+        sheet->frames[i].w = frameWidth;
+        sheet->frames[i].h = frameHeight;
+    }
+    return sheet;
+}
+
+const AnimationSheet* AnimationSheets::FromTextures(const TextureID* ids, int frameCount) {
+    AnimationSheet* sheet = NewSheet(frameCount);
+    if (!sheet) return nullptr;
+
+    for (int i = 0; i < frameCount; i++) {
+        Texture* texture = ResourceManager::GetTexture(ids[i]);
+        sheet->textures[i] = texture;
+        sheet->frames[i] = texture ? texture->atlasRect : SDL_Rect{0, 0, 0, 0};
+    }
+    return sheet;
+}
+
+void AnimationSheets::Clear() {
+    sheetCount = 0;
+}
+
+void AnimationSystem::Init() {
+    DeclareAccess(0, COMPONENT_ANIMATION | COMPONENT_SPRITE);
+    printf("AnimationSystem initialized\n");
+}
+
+void AnimationSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
+    // Every animated sprite in one pass over the packed view. Most entities
+    // only bump their accumulator, the sprite is touched on frame changes.
+    EntityView* view = entities->View<AnimationComponent, SpriteComponent>();
+    for (EntityID entity : *view) {
+        AnimationComponent& anim = components->Get<AnimationComponent>(entity);
+        if (!anim.playing) continue;
+
+        anim.accumulator += deltaTime;
+        if (anim.accumulator < anim.frameTime) continue;
+
+        // A long step can cover several frames, skip them all at once
+        int steps = (int)(anim.accumulator / anim.frameTime);
+        anim.accumulator -= steps * anim.frameTime;
+
+        int frameCount = anim.sheet->frameCount;
+        int frame = anim.currentFrame + steps;
+        if (frame >= frameCount) {
+            if (anim.loop) {
+                frame %= frameCount;
+            } else {
+                frame = frameCount - 1;
+                anim.playing = false;
+            }
+        }
+
+        if (frame != anim.currentFrame) {
+            anim.currentFrame = frame;
+            anim.ApplyTo(components->sprites[entity]);
+        }
+    }
+}
+
+void AnimationSystem::Destroy() {
+    AnimationSheets::Clear();
+    printf("AnimationSystem destroyed\n");
+}
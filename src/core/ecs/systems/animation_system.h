@@ -1,33 +1,32 @@
+#pragma once
+#include "../systems.h"
+#include "../entity.h"
+#include "../components.h"
 
-#include "../engine.h"
+#define MAX_ANIMATION_SHEETS 32
 
-class AnimationSystem {
-public:
-    void Update(float deltaTime) {
-        auto view = g_Engine.entityManager.GetEntitiesWith<AnimationComponent>();
-        
-        for (auto entity : view) {
-            auto& anim = g_Engine.entityManager.GetComponent<AnimationComponent>(entity);
-            
-            if (!anim.playing) continue;
-            
-            anim.accumulator += deltaTime;
-            
-            if (anim.accumulator >= anim.frameTime) {
-                anim.accumulator -= anim.frameTime;
-                
-                anim.currentFrame++;
-                if (anim.currentFrame >= anim.totalFrames) {
-                    if (anim.loop) {
-                        anim.currentFrame = 0;
-                    } else {
-                        anim.currentFrame = anim.totalFrames - 1;
-                        anim.playing = false;
-                    }
-                }
-                
-                anim.UpdateFrameRect();
-            }
-        }
-    }
-}; 
\ No newline at end of file
+// Owns every AnimationSheet. Sheets are built once at load time and shared by
+// all the entities playing them.
+struct AnimationSheets {
+    // frameCount frames of frameWidth x frameHeight, row by row in a grid of
+    // columns inside the texture
+    static const AnimationSheet* FromGrid(Texture* texture, int frameWidth, int frameHeight,
+                                          int columns, int frameCount);
+    // One whole texture per frame
+    static const AnimationSheet* FromTextures(const TextureID* ids, int frameCount);
+    static void Clear();
+
+private:
+    static AnimationSheet* NewSheet(int frameCount);
+
+    static AnimationSheet sheets[MAX_ANIMATION_SHEETS];
+    static int sheetCount;
+};
+
+// Advances every animation and writes the current frame into the entity's
+// sprite, so animated entities go through the normal render queue
+struct AnimationSystem : System {
+    void Init() override;
+    void Update(float deltaTime, EntityManager* entities, ComponentArrays* components) override;
+    void Destroy() override;
+};
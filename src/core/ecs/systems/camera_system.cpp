@@ -4,41 +4,40 @@
 #include <math.h>
 
 void CameraSystem::Init() {
+    DeclareAccess(COMPONENT_TRANSFORM, COMPONENT_CAMERA);
     printf("CameraSystem initialized\n");
 }
 
 void CameraSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_CAMERA)) {
-            CameraComponent* camera = &components->cameras[entity];
-            
-            if (camera->targetEntity == 0) continue;
-            
-            // Get target's transform
-            TransformComponent* targetTransform = 
-                (TransformComponent*)components->GetComponentData(camera->targetEntity, COMPONENT_TRANSFORM);
-            
-            if (!targetTransform) continue;
+    EntityView* view = entities->View(COMPONENT_CAMERA);
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        CameraComponent* camera = &components->cameras[entity];
+        
+        if (camera->targetEntity == 0) continue;
+        
+        // Get target's transform, skipping targets that were destroyed
+        if (!entities->IsEntityValid(camera->targetEntity)) continue;
+        TransformRef targetTransform = components->transforms[camera->targetEntity];
 
-            // Gradually reduce camera kick
-            if (camera->cameraKick != 0) {
-                camera->cameraKick *= 0.95f;  // Reduce kick by 5% each frame
-                if (fabs(camera->cameraKick) < 0.1f) {
-                    camera->cameraKick = 0;
-                }
+        // Gradually reduce camera kick
+        if (camera->cameraKick != 0) {
+            camera->cameraKick *= powf(0.95f, deltaTime * REFERENCE_FRAME_RATE);  // Reduce kick by 5% per 60Hz frame
+            if (fabs(camera->cameraKick) < 0.1f) {
+                camera->cameraKick = 0;
             }
+        }
 
-            // Calculate target position (center of screen)
-            camera->targetX = targetTransform->x - camera->viewportWidth/2;
-            camera->targetY = targetTransform->y - camera->viewportHeight/2 + 325.0f + camera->cameraKick;
+        // Calculate target position (center of screen)
+        camera->targetX = targetTransform->x - camera->viewportWidth/2;
+        camera->targetY = targetTransform->y - camera->viewportHeight/2 + 325.0f + camera->cameraKick;
 
-            // Smooth follow
-            camera->x += (camera->targetX - camera->x) * CAMERA_FOLLOW_SPEED*4 * deltaTime;
-            camera->y += (camera->targetY - camera->y) * CAMERA_FOLLOW_SPEED * deltaTime;
+        // Smooth follow
+        camera->x += (camera->targetX - camera->x) * CAMERA_FOLLOW_SPEED*4 * deltaTime;
+        camera->y += (camera->targetY - camera->y) * CAMERA_FOLLOW_SPEED * deltaTime;
 
-            // clamp at the bottom
-            camera->y = std::min((float)GAME_HEIGHT - 200, camera->y);
-        }
+        // clamp at the bottom
+        camera->y = std::min((float)GAME_HEIGHT - 200, camera->y);
     }
 }
 
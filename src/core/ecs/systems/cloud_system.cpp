@@ -1,11 +1,74 @@
 #include "cloud_system.h"
+#include "../../job_system.h"
 #include <stdio.h>
+#include <stdlib.h>
 
 void CloudSystem::Init() {
+    DeclareAccess(COMPONENT_TRANSFORM | COMPONENT_SPRITE | COMPONENT_CLOUD,
+                  COMPONENT_SQUIRREL | SYSTEM_RESOURCE_AUDIO);
     printf("CloudSystem initialized\n");
     cloudHitSoundID = SOUND_CLOUD_HIT;
     cloudBounceSoundID = SOUND_CLOUD_BOUNCE;
     hitSoundCooldown = 0.0f;
+    cloudIndex.Init();
+    maxCloudHeight = 0.0f;
+    cloudViewVersion = 0;
+    cloudIndexBuilt = false;
+}
+
+static int CompareCloudTop(const void* a, const void* b) {
+    float topA = ((const CloudIndexEntry*)a)->top;
+    float topB = ((const CloudIndexEntry*)b)->top;
+    return (topA > topB) - (topA < topB);
+}
+
+void CloudSystem::RebuildCloudIndex(EntityView* cloudView, ComponentArrays* components) {
+    cloudIndex.Reserve(cloudView->dense.count);
+    cloudIndex.count = cloudView->dense.count;
+
+    // Every entry only depends on its own cloud, fill them on the job threads
+    JobSystem::ParallelFor(cloudView->dense.count, CLOUD_INDEX_CHUNK, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t v = begin; v < end; v++) {
+            EntityID cloudEntity = cloudView->dense[v];
+            TransformRef cloudTransform = components->transforms[cloudEntity];
+            SpriteRef cloudSprite = components->sprites[cloudEntity];
+
+            // Calculate cloud boundaries // btw there are hacks here because sprite is centered at transform coordinates
+            CloudIndexEntry* entry = &cloudIndex[v];
+            entry->entity = cloudEntity;
+            entry->top = cloudTransform->y - cloudSprite->height/2 + COLLISION_GRACE_DISTANCE;
+            entry->bottom = cloudTransform->y + cloudSprite->height/2 - COLLISION_GRACE_DISTANCE;
+            entry->left = cloudTransform->x - cloudSprite->width/2 + 3*COLLISION_GRACE_DISTANCE;
+            entry->right = cloudTransform->x + cloudSprite->width/2;
+        }
+    });
+
+    maxCloudHeight = 0.0f;
+    for (uint32_t c = 0; c < cloudIndex.count; c++) {
+        if (cloudIndex[c].bottom - cloudIndex[c].top > maxCloudHeight) {
+            maxCloudHeight = cloudIndex[c].bottom - cloudIndex[c].top;
+        }
+    }
+
+    qsort(cloudIndex.data, cloudIndex.count, sizeof(CloudIndexEntry), CompareCloudTop);
+
+    cloudViewVersion = cloudView->version;
+    cloudIndexBuilt = true;
+}
+
+int CloudSystem::FindFirstCloudWithTopAbove(float y) {
+    // Binary search (lower bound) on the sorted top edges
+    int low = 0;
+    int high = cloudIndex.count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (cloudIndex[mid].top < y) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
 }
 
 void CloudSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
@@ -15,47 +78,40 @@ void CloudSystem::Update(float deltaTime, EntityManager* entities, ComponentArra
     }
 
     // Find squirrel entity first
-    EntityID squirrelEntity = 0;
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_SQUIRREL)) {
-            squirrelEntity = entity;
-            break;
-        }
-    }
-    
-    if (!squirrelEntity) return;
+    EntityView* squirrelView = entities->View(COMPONENT_SQUIRREL);
+    if (squirrelView->dense.count == 0) return;
+
+    EntityID squirrelEntity = squirrelView->dense[0];
     
-    TransformComponent* squirrelTransform = &components->transforms[squirrelEntity];
+    TransformRef squirrelTransform = components->transforms[squirrelEntity];
     SquirrelComponent* squirrel = &components->squirrelComponents[squirrelEntity];
     
-    // Check all clouds
-    for (EntityID cloudEntity = 1; cloudEntity < MAX_ENTITIES; cloudEntity++) {
-        if (!entities->HasComponent(cloudEntity, COMPONENT_CLOUD)) continue;
-        
-        CloudComponent* cloud = &components->clouds[cloudEntity];
-        TransformComponent* cloudTransform = &components->transforms[cloudEntity];
-        SpriteComponent* cloudSprite = &components->sprites[cloudEntity];
-        
-        // Calculate cloud boundaries // btw there are hacks here because sprite is centered at transform coordinates
-        float cloudTop = cloudTransform->y - cloudSprite->height/2 + COLLISION_GRACE_DISTANCE;
-        float cloudBottom = cloudTransform->y + cloudSprite->height/2 - COLLISION_GRACE_DISTANCE;
-        float cloudLeft = cloudTransform->x - cloudSprite->width/2 + 3*COLLISION_GRACE_DISTANCE;
-        float cloudRight = cloudTransform->x + cloudSprite->width/2;
-        
-        // Calculate squirrel boundaries
-        SpriteComponent* squirrelSprite = &components->sprites[squirrelEntity];
-        float squirrelTop = squirrelTransform->y;
-        float squirrelBottom = squirrelTransform->y + squirrelSprite->height;
-        float squirrelLeft = squirrelTransform->x;
-        float squirrelRight = squirrelTransform->x + squirrelSprite->width;
+    EntityView* cloudView = entities->View(COMPONENT_CLOUD);
+    if (!cloudIndexBuilt || cloudViewVersion != cloudView->version) {
+        RebuildCloudIndex(cloudView, components);
+    }
+
+    // Calculate squirrel boundaries
+    SpriteRef squirrelSprite = components->sprites[squirrelEntity];
+    float squirrelTop = squirrelTransform->y;
+    float squirrelBottom = squirrelTransform->y + squirrelSprite->height;
+    float squirrelLeft = squirrelTransform->x;
+    float squirrelRight = squirrelTransform->x + squirrelSprite->width;
+
+    // Check only clouds whose vertical extent can reach the squirrel: a cloud
+    // starting more than maxCloudHeight above it cannot overlap
+    int first = FindFirstCloudWithTopAbove(squirrelTop - maxCloudHeight);
+    for (int c = first; c < (int)cloudIndex.count && cloudIndex[c].top < squirrelBottom; c++) {
+        const CloudIndexEntry& entry = cloudIndex[c];
+        CloudComponent* cloud = &components->clouds[entry.entity];
         
         // Check for collision
-        if (squirrelRight > cloudLeft && squirrelLeft < cloudRight &&
-            squirrelBottom > cloudTop && squirrelTop < cloudBottom) {
+        if (squirrelRight > entry.left && squirrelLeft < entry.right &&
+            squirrelBottom > entry.top && squirrelTop < entry.bottom) {
 
             // printf("Squirrel: (%.1f,%.1f)-(%.1f,%.1f) Cloud: (%.1f,%.1f)-(%.1f,%.1f)\n",
             //     squirrelLeft, squirrelTop, squirrelRight, squirrelBottom,
-            //     cloudLeft, cloudTop, cloudRight, cloudBottom);
+            //     entry.left, entry.top, entry.right, entry.bottom);
 
             if (squirrel->hasShield) {
                 printf("protected from cloud!\n");
@@ -68,11 +124,7 @@ void CloudSystem::Update(float deltaTime, EntityManager* entities, ComponentArra
                 squirrel->state = SQUIRREL_STATE_WIGGLING;
                 
                 // Play cloud hit sound
-                Sound* hitSound = ResourceManager::GetSound(cloudHitSoundID);
-                if (hitSound) {
-                    hitSound->sdlChunk->volume = 32;  // Quarter volume (0-128)
-                    Mix_PlayChannel(-1, hitSound->sdlChunk, 0);
-                }
+                ResourceManager::PlaySound(cloudHitSoundID, 32);  // Quarter volume (0-128)
             }
             else if (cloud->type == CLOUD_BLACK) {
                 // Bounce effect
@@ -80,12 +132,8 @@ void CloudSystem::Update(float deltaTime, EntityManager* entities, ComponentArra
                 
                 // Play bounce sound at higher volume
                 if (hitSoundCooldown <= 0.0f) {
-                    Sound* cloudSound = ResourceManager::GetSound(cloudBounceSoundID);
-                    if (cloudSound) {
-                        cloudSound->sdlChunk->volume = 32;  // Quarter volume (0-128)
-                        Mix_PlayChannel(-1, cloudSound->sdlChunk, 0);
-                        hitSoundCooldown = HIT_SOUND_COOLDOWN_TIME;  // Reset cooldown
-                    }
+                    ResourceManager::PlaySound(cloudBounceSoundID, 32);  // Quarter volume (0-128)
+                    hitSoundCooldown = HIT_SOUND_COOLDOWN_TIME;  // Reset cooldown
                 }
             }
         }
@@ -93,5 +141,6 @@ void CloudSystem::Update(float deltaTime, EntityManager* entities, ComponentArra
 }
 
 void CloudSystem::Destroy() {
+    cloudIndex.Destroy();
     printf("CloudSystem destroyed\n");
 } 
\ No newline at end of file
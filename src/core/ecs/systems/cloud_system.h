@@ -4,6 +4,13 @@
 #include "../components.h"
 
 #define COLLISION_GRACE_DISTANCE 15 // px
+#define CLOUD_INDEX_CHUNK 256       // Clouds per ParallelFor job when rebuilding the index
+
+// Hit box of one cloud, as tested against the squirrel
+struct CloudIndexEntry {
+    float top, bottom, left, right;
+    EntityID entity;
+};
 
 struct CloudSystem : System {
     void Init() override;
@@ -15,4 +22,15 @@ private:
     SoundID cloudBounceSoundID;
     float hitSoundCooldown;
     const float HIT_SOUND_COOLDOWN_TIME = 0.5f;
-}; 
\ No newline at end of file
+
+    // Clouds never move once spawned, so their hit boxes are kept sorted by
+    // top edge and only rebuilt when the cloud view changes. A frame then only
+    // looks at the clouds overlapping the squirrel's vertical band.
+    GrowableArray<CloudIndexEntry> cloudIndex;
+    float maxCloudHeight;       // Tallest hit box, bounds the backwards search
+    uint32_t cloudViewVersion;
+    bool cloudIndexBuilt;
+
+    void RebuildCloudIndex(EntityView* cloudView, ComponentArrays* components);
+    int FindFirstCloudWithTopAbove(float y);  // First entry with top >= y
+}; 
@@ -1,15 +1,24 @@
 #include "collision_system.h"
+#include "../../job_system.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void CollisionSystem::Init() {
+    DeclareAccess(COMPONENT_COLLIDER, COMPONENT_TRANSFORM);
     printf("CollisionSystem initialized\n");
     collisionCount = 0;
+    candidatePairCount = 0;
+    staticViewVersion = 0;
+    staticGridBuilt = false;
+    probes.Init();
+    recheck.Init();
+    testedEntities.Init();
 }
 
 bool CollisionSystem::CheckCollision(
-    TransformComponent* transformA, ColliderComponent* colliderA,
-    TransformComponent* transformB, ColliderComponent* colliderB,
+    TransformRef transformA, ColliderRef colliderA,
+    TransformRef transformB, ColliderRef colliderB,
     float& penetrationX, float& penetrationY) 
 {
     // Calculate boundaries for first box
@@ -44,8 +53,8 @@ bool CollisionSystem::CheckCollision(
 }
 
 void CollisionSystem::ResolveCollision(
-    TransformComponent* transformA, ColliderComponent* colliderA,
-    TransformComponent* transformB, ColliderComponent* colliderB,
+    TransformRef transformA, ColliderRef colliderA,
+    TransformRef transformB, ColliderRef colliderB,
     float penetrationX, float penetrationY) 
 {
     if (colliderA->isTrigger || colliderB->isTrigger) {
@@ -90,51 +99,229 @@ void CollisionSystem::ResolveCollision(
     }
 }
 
+GridBox CollisionSystem::GetColliderBox(TransformRef transform, ColliderRef collider) {
+    GridBox box;
+    box.left = transform->x;
+    box.top = transform->y;
+    box.right = transform->x + collider->width;
+    box.bottom = transform->y + collider->height;
+    return box;
+}
+
+float CollisionSystem::ComputeCellSize(EntityView* view, ComponentArrays* components) {
+    // Size cells after the largest dynamic collider so each one touches at most
+    // 2x2 cells. Rounded up to a power of two so small size changes don't force
+    // the static grid to be rebuilt.
+    float maxExtent = 0.0f;
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        ColliderRef collider = components->colliders[view->dense[v]];
+        if (collider->isStatic) continue;
+        if (collider->width > maxExtent) maxExtent = collider->width;
+        if (collider->height > maxExtent) maxExtent = collider->height;
+    }
+
+    float cellSize = COLLISION_MIN_CELL_SIZE;
+    while (cellSize < maxExtent) {
+        cellSize *= 2.0f;
+    }
+    return cellSize;
+}
+
+void CollisionSystem::RebuildStaticGrid(EntityView* view, ComponentArrays* components, float cellSize) {
+    staticGrid.Init(cellSize);
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        ColliderRef collider = components->colliders[entity];
+        if (!collider->isStatic) continue;
+
+        staticGrid.Insert(entity, GetColliderBox(components->transforms[entity], collider));
+    }
+
+    staticViewVersion = view->version;
+    staticGridBuilt = true;
+}
+
+void CollisionSystem::TestPair(EntityID entityA, EntityID entityB, EntityView* view, ComponentArrays* components) {
+    // Keep the lower ID first, same pair order as the old all-pairs loop
+    if (entityB < entityA) {
+        EntityID temp = entityA;
+        entityA = entityB;
+        entityB = temp;
+    }
+
+    TransformRef transformA = components->transforms[entityA];
+    ColliderRef colliderA = components->colliders[entityA];
+    TransformRef transformB = components->transforms[entityB];
+    ColliderRef colliderB = components->colliders[entityB];
+
+    candidatePairCount++;
+
+    float penetrationX, penetrationY;
+    if (CheckCollision(transformA, colliderA, transformB, colliderB, 
+                     penetrationX, penetrationY)) 
+    {
+        GridBox oldBoxA = GetColliderBox(transformA, colliderA);
+        GridBox oldBoxB = GetColliderBox(transformB, colliderB);
+
+        // Store collision
+        if (collisionCount < MAX_COLLISIONS) {
+            collisions[collisionCount].entityA = entityA;
+            collisions[collisionCount].entityB = entityB;
+            collisions[collisionCount].penetrationX = penetrationX;
+            collisions[collisionCount].penetrationY = penetrationY;
+            collisionCount++;
+        }
+        
+        // Resolve collision
+        ResolveCollision(transformA, colliderA, transformB, colliderB,
+                       penetrationX, penetrationY);
+
+        if (!colliderA->isTrigger && !colliderB->isTrigger) {
+            if (!colliderA->isStatic) MoveInGrid(entityA, oldBoxA, view, components);
+            if (!colliderB->isStatic) MoveInGrid(entityB, oldBoxB, view, components);
+        }
+    }
+}
+
+// Re-bins a dynamic collider a resolve just pushed, so later queries see it
+// where it is now and not where the step started. Whatever it now overlaps,
+// itself included, can no longer trust its probe.
+void CollisionSystem::MoveInGrid(EntityID entity, const GridBox& oldBox, EntityView* view, ComponentArrays* components) {
+    GridBox box = GetColliderBox(components->transforms[entity], components->colliders[entity]);
+    dynamicGrid.Remove(entity, oldBox);
+    dynamicGrid.Insert(entity, box);
+
+    recheck[view->sparse[entity] - 1] = 1;
+    int count = dynamicGrid.Query(box, touched, MAX_CANDIDATES);
+    for (int c = 0; c < count; c++) {
+        recheck[view->sparse[touched[c]] - 1] = 1;
+    }
+}
+
+bool CollisionSystem::WasTested(EntityID entity) {
+    for (uint32_t i = 0; i < testedEntities.count; i++) {
+        if (testedEntities[i] == entity) return true;
+    }
+    return false;
+}
+
+void CollisionSystem::ProbeRange(EntityView* view, ComponentArrays* components, uint32_t begin, uint32_t end) {
+    // Runs on any thread: only reads, and writes its own probes
+    uint32_t found[MAX_CANDIDATES];
+
+    for (uint32_t v = begin; v < end; v++) {
+        EntityID entityA = view->dense[v];
+        TransformRef transformA = components->transforms[entityA];
+        ColliderRef colliderA = components->colliders[entityA];
+        CollisionProbe* probe = &probes[v];
+        probe->candidateCount = 0;
+        probe->hit = false;
+        if (colliderA->isStatic) continue;
+
+        GridBox boxA = GetColliderBox(transformA, colliderA);
+        float penetrationX, penetrationY;
+
+        int count = staticGrid.Query(boxA, found, MAX_CANDIDATES);
+        for (int c = 0; c < count; c++) {
+            probe->candidateCount++;
+            if (CheckCollision(transformA, colliderA, components->transforms[found[c]], components->colliders[found[c]],
+                               penetrationX, penetrationY)) {
+                probe->hit = true;
+            }
+        }
+
+        count = dynamicGrid.Query(boxA, found, MAX_CANDIDATES);
+        for (int c = 0; c < count; c++) {
+            if (found[c] <= entityA) continue;
+            probe->candidateCount++;
+            if (CheckCollision(transformA, colliderA, components->transforms[found[c]], components->colliders[found[c]],
+                               penetrationX, penetrationY)) {
+                probe->hit = true;
+            }
+        }
+    }
+}
+
 void CollisionSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
     collisionCount = 0;
+    candidatePairCount = 0;
     
-    // Check collisions between all entities with colliders
-    for (EntityID entityA = 1; entityA < MAX_ENTITIES; entityA++) {
-        if (!entities->HasComponent(entityA, COMPONENT_TRANSFORM | COMPONENT_COLLIDER)) {
+    EntityView* view = entities->View(COMPONENT_TRANSFORM | COMPONENT_COLLIDER);
+
+    float cellSize = ComputeCellSize(view, components);
+    if (!staticGridBuilt || staticViewVersion != view->version || staticGrid.cellSize != cellSize) {
+        RebuildStaticGrid(view, components, cellSize);
+    }
+
+    // Re-bin the dynamic colliders
+    dynamicGrid.Init(cellSize);
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        ColliderRef collider = components->colliders[entity];
+        if (collider->isStatic) continue;
+
+        dynamicGrid.Insert(entity, GetColliderBox(components->transforms[entity], collider));
+    }
+
+    probes.Reserve(view->dense.count);
+    probes.count = view->dense.count;
+    JobSystem::ParallelFor(view->dense.count, COLLISION_PROBE_CHUNK, [&](uint32_t begin, uint32_t end) {
+        ProbeRange(view, components, begin, end);
+    });
+
+    recheck.Reserve(view->dense.count);
+    recheck.count = view->dense.count;
+    memset(recheck.data, 0, view->dense.count);
+
+    // Only dynamic colliders can start a pair: static vs static never moves
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entityA = view->dense[v];
+        ColliderRef colliderA = components->colliders[entityA];
+        if (colliderA->isStatic) continue;
+
+        // Same positions as when probed and nothing hit, resolving it would
+        // only have counted the candidates
+        if (!probes[v].hit && !recheck[v]) {
+            candidatePairCount += probes[v].candidateCount;
             continue;
         }
-        
-        TransformComponent* transformA = 
-            (TransformComponent*)components->GetComponentData(entityA, COMPONENT_TRANSFORM);
-        ColliderComponent* colliderA = 
-            (ColliderComponent*)components->GetComponentData(entityA, COMPONENT_COLLIDER);
-            
-        for (EntityID entityB = entityA + 1; entityB < MAX_ENTITIES; entityB++) {
-            if (!entities->HasComponent(entityB, COMPONENT_TRANSFORM | COMPONENT_COLLIDER)) {
-                continue;
+
+        // A resolve can push A itself. Look again from where it ended up,
+        // like the old all-pairs loop testing every later pair at the current
+        // positions, but test each pair only once per step.
+        TransformRef transformA = components->transforms[entityA];
+        testedEntities.Clear();
+        for (int pass = 0; pass < COLLISION_MAX_PASSES; pass++) {
+            float startX = transformA->x;
+            float startY = transformA->y;
+            GridBox boxA = GetColliderBox(transformA, colliderA);
+
+            int count = staticGrid.Query(boxA, candidates, MAX_CANDIDATES);
+            for (int c = 0; c < count; c++) {
+                if (pass > 0 && WasTested(candidates[c])) continue;
+                testedEntities.Push(candidates[c]);
+                TestPair(entityA, candidates[c], view, components);
             }
-            
-            TransformComponent* transformB = 
-                (TransformComponent*)components->GetComponentData(entityB, COMPONENT_TRANSFORM);
-            ColliderComponent* colliderB = 
-                (ColliderComponent*)components->GetComponentData(entityB, COMPONENT_COLLIDER);
-                
-            float penetrationX, penetrationY;
-            if (CheckCollision(transformA, colliderA, transformB, colliderB, 
-                             penetrationX, penetrationY)) 
-            {
-                // Store collision
-                if (collisionCount < MAX_COLLISIONS) {
-                    collisions[collisionCount].entityA = entityA;
-                    collisions[collisionCount].entityB = entityB;
-                    collisions[collisionCount].penetrationX = penetrationX;
-                    collisions[collisionCount].penetrationY = penetrationY;
-                    collisionCount++;
-                }
-                
-                // Resolve collision
-                ResolveCollision(transformA, colliderA, transformB, colliderB,
-                               penetrationX, penetrationY);
+
+            // Each dynamic pair is found from both sides, keep it once
+            count = dynamicGrid.Query(boxA, candidates, MAX_CANDIDATES);
+            for (int c = 0; c < count; c++) {
+                if (candidates[c] <= entityA) continue;
+                if (pass > 0 && WasTested(candidates[c])) continue;
+                testedEntities.Push(candidates[c]);
+                TestPair(entityA, candidates[c], view, components);
             }
+
+            if (transformA->x == startX && transformA->y == startY) break;
         }
     }
 }
 
 void CollisionSystem::Destroy() {
+    staticGrid.Destroy();
+    dynamicGrid.Destroy();
+    probes.Destroy();
+    recheck.Destroy();
+    testedEntities.Destroy();
     printf("CollisionSystem destroyed\n");
 } 
\ No newline at end of file
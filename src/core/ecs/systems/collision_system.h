@@ -1,5 +1,11 @@
 #pragma once
 #include "../systems.h"
+#include "../../spatial_grid.h"
+#include "../paged_array.h"
+
+#define COLLISION_MIN_CELL_SIZE 16.0f  // Smallest broadphase cell, in px
+#define COLLISION_PROBE_CHUNK 64       // Dynamic colliders per ParallelFor job
+#define COLLISION_MAX_PASSES 4         // Re-queries for a collider its own resolves keep pushing
 
 struct Collision {
     EntityID entityA;
@@ -8,23 +14,60 @@ struct Collision {
     float penetrationY;
 };
 
+// What a dynamic collider found against the unresolved positions
+struct CollisionProbe {
+    int candidateCount;
+    bool hit;
+};
+
 struct CollisionSystem : System {
     static const int MAX_COLLISIONS = 1024;
+    static const int MAX_CANDIDATES = 1024;
     Collision collisions[MAX_COLLISIONS];
     int collisionCount;
 
+    // Pairs handed to the narrowphase last frame (for profiling)
+    int candidatePairCount;
+
     void Init() override;
     void Update(float deltaTime, EntityManager* entities, ComponentArrays* components) override;
     void Destroy() override;
 
 private:
+    // Broadphase. Static colliders are binned once and only re-binned when the
+    // collider set or the cell size changes; dynamic ones are re-binned every
+    // frame, and again whenever a resolve moves one.
+    SpatialGrid staticGrid;
+    SpatialGrid dynamicGrid;
+    uint32_t staticViewVersion;
+    bool staticGridBuilt;
+    uint32_t candidates[MAX_CANDIDATES];
+
+    // Narrowphase. Every dynamic collider is first checked against its
+    // candidates in parallel without resolving anything. Resolution then runs
+    // in view order as before, skipping colliders that hit nothing and that
+    // nothing resolved this step has moved into, so the result stays exact.
+    GrowableArray<CollisionProbe> probes;   // Indexed like view->dense
+    GrowableArray<uint8_t> recheck;         // Indexed like view->dense, set when a resolve moved into it
+    GrowableArray<EntityID> testedEntities; // Already paired with the current collider
+    uint32_t touched[MAX_CANDIDATES];       // What a moved collider overlaps now
+
+    void ProbeRange(EntityView* view, ComponentArrays* components, uint32_t begin, uint32_t end);
+    float ComputeCellSize(EntityView* view, ComponentArrays* components);
+    void RebuildStaticGrid(EntityView* view, ComponentArrays* components, float cellSize);
+    void TestPair(EntityID entityA, EntityID entityB, EntityView* view, ComponentArrays* components);
+    void MoveInGrid(EntityID entity, const GridBox& oldBox, EntityView* view, ComponentArrays* components);
+    bool WasTested(EntityID entity);
+
+    static GridBox GetColliderBox(TransformRef transform, ColliderRef collider);
+
     bool CheckCollision(
-        TransformComponent* transformA, ColliderComponent* colliderA,
-        TransformComponent* transformB, ColliderComponent* colliderB,
+        TransformRef transformA, ColliderRef colliderA,
+        TransformRef transformB, ColliderRef colliderB,
         float& penetrationX, float& penetrationY);
     
     void ResolveCollision(
-        TransformComponent* transformA, ColliderComponent* colliderA,
-        TransformComponent* transformB, ColliderComponent* colliderB,
+        TransformRef transformA, ColliderRef colliderA,
+        TransformRef transformB, ColliderRef colliderB,
         float penetrationX, float penetrationY);
-}; 
\ No newline at end of file
+}; 
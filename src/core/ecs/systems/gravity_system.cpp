@@ -1,28 +1,28 @@
 #include "gravity_system.h"
 
 void GravitySystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_TRANSFORM | COMPONENT_GRAVITY)) {
-            TransformComponent* transform = 
-                (TransformComponent*)components->GetComponentData(entity, COMPONENT_TRANSFORM);
-            GravityComponent* gravity = 
-                (GravityComponent*)components->GetComponentData(entity, COMPONENT_GRAVITY);
+    EntityView* view = entities->View(COMPONENT_TRANSFORM | COMPONENT_GRAVITY);
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        TransformRef transform = components->transforms[entity];
+        GravityComponent* gravity = &components->Get<GravityComponent>(entity);
+        
+        if (!gravity->isGrounded) {
+            // Apply gravity
+            gravity->velocityY += GRAVITY * gravity->gravityScale * deltaTime;
             
-            if (!gravity->isGrounded) {
-                // Apply gravity
-                gravity->velocityY += GRAVITY * gravity->gravityScale * deltaTime;
-                
-                // Update position
-                transform->y += gravity->velocityY * deltaTime;
-            }
-            
-            // Reset grounded state each frame
-            // (CollisionSystem will set it to true if needed)
-            gravity->isGrounded = false;
+            // Update position
+            transform->y += gravity->velocityY * deltaTime;
         }
+        
+        // Reset grounded state each frame
+        // (CollisionSystem will set it to true if needed)
+        gravity->isGrounded = false;
     }
 }
 
-void GravitySystem::Init() {}
+void GravitySystem::Init() {
+    DeclareAccess(0, COMPONENT_TRANSFORM | COMPONENT_GRAVITY);
+}
 void GravitySystem::Destroy() {}
 
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 void MusicSystem::Init() {
+    DeclareAccess(COMPONENT_TRANSFORM | COMPONENT_SQUIRREL, SYSTEM_RESOURCE_AUDIO);
     isMusicPlaying = false;
     wasKeyPressed = false;
     backgroundMusicID = SOUND_BACKGROUND_MUSIC;
@@ -14,6 +15,7 @@ void MusicSystem::Init() {
     windChannel = -1;
     isHelicopterPlaying = false;
     isWindPlaying = false;
+    isMusicPending = false;
     
     PlayMusic();
     printf("MusicSystem initialized\n");
@@ -30,18 +32,22 @@ void MusicSystem::Update(float deltaTime, EntityManager* entities, ComponentArra
         wasKeyPressed = false;
     }
 
+    // The music may still have been decoding when it was asked for
+    if (isMusicPending && ResourceManager::GetSound(backgroundMusicID)) {
+        PlayMusic();
+    }
+
     // Update helicopter and wind sounds
     UpdateHelicopterSound(g_Game.helicopterEntity, g_Game.squirrelEntity);
     UpdateWindSound(g_Game.squirrelEntity);
 }
 
 void MusicSystem::UpdateHelicopterSound(EntityID helicopterEntity, EntityID squirrelEntity) {
-    TransformComponent* heliTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(helicopterEntity, COMPONENT_TRANSFORM);
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
+    if (!g_Engine.entityManager.IsEntityValid(helicopterEntity) ||
+        !g_Engine.entityManager.IsEntityValid(squirrelEntity)) return;
 
-    if (!heliTransform || !squirrelTransform) return;
+    TransformRef heliTransform = g_Engine.componentArrays.transforms[helicopterEntity];
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
 
     // Calculate distance between helicopter and squirrel
     float dx = heliTransform->x - squirrelTransform->x;
@@ -58,23 +64,19 @@ void MusicSystem::UpdateHelicopterSound(EntityID helicopterEntity, EntityID squi
     // Start playing helicopter sound if not already playing
     if (volume > 0) {
         if (!isHelicopterPlaying) {
-            Sound* heliSound = ResourceManager::GetSound(helicopterSoundID);
-            if (heliSound) {
-                heliSound->sdlChunk->volume = volume;
-                helicopterChannel = Mix_PlayChannel(-1, heliSound->sdlChunk, -1);  // Loop infinitely
-                isHelicopterPlaying = true;
-            }
+            helicopterChannel = ResourceManager::PlaySound(helicopterSoundID, volume, -1);  // Loop infinitely
+            isHelicopterPlaying = helicopterChannel != -1;
         }
     } else if (isHelicopterPlaying) {
         // Stop helicopter sound when too far
-        Mix_HaltChannel(helicopterChannel);
+        ResourceManager::HaltChannel(helicopterChannel);
         isHelicopterPlaying = false;
     }
 }
 
 void MusicSystem::UpdateWindSound(EntityID squirrelEntity) {
     SquirrelComponent* squirrel = 
-        (SquirrelComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, squirrelEntity);
     
     if (!squirrel) return;
 
@@ -93,15 +95,11 @@ void MusicSystem::UpdateWindSound(EntityID squirrelEntity) {
     // Start or update wind sound
     if (volume > 0) {
         if (!isWindPlaying) {
-            Sound* windSound = ResourceManager::GetSound(windSoundID);
-            if (windSound) {
-                windSound->sdlChunk->volume = volume;
-                windChannel = Mix_PlayChannel(-1, windSound->sdlChunk, -1);  // Loop infinitely
-                isWindPlaying = true;
-            }
+            windChannel = ResourceManager::PlaySound(windSoundID, volume, -1);  // Loop infinitely
+            isWindPlaying = windChannel != -1;
         }
     } else if (isWindPlaying) {
-        Mix_HaltChannel(windChannel);
+        ResourceManager::HaltChannel(windChannel);
         isWindPlaying = false;
     }
 }
@@ -115,11 +113,14 @@ void MusicSystem::ToggleMusic() {
 }
 
 void MusicSystem::PlayMusic() {
-    ResourceManager::PlayMusic(backgroundMusicID, -1);  // -1 for infinite loop
     isMusicPlaying = true;
+    isMusicPending = !ResourceManager::GetSound(backgroundMusicID);
+    if (isMusicPending) return;
+    ResourceManager::PlayMusic(backgroundMusicID, -1);  // -1 for infinite loop
 }
 
 void MusicSystem::StopMusic() {
+    isMusicPending = false;
     ResourceManager::StopMusic();
     isMusicPlaying = false;
 }
@@ -127,10 +128,10 @@ void MusicSystem::StopMusic() {
 void MusicSystem::Destroy() {
     StopMusic();
     if (isHelicopterPlaying) {
-        Mix_HaltChannel(helicopterChannel);
+        ResourceManager::HaltChannel(helicopterChannel);
     }
     if (isWindPlaying) {
-        Mix_HaltChannel(windChannel);
+        ResourceManager::HaltChannel(windChannel);
     }
     printf("MusicSystem destroyed\n");
 } 
\ No newline at end of file
@@ -18,6 +18,7 @@ struct MusicSystem : System {
 
 private:
     bool isMusicPlaying;
+    bool isMusicPending;  // Asked to play before the music finished loading
     bool wasKeyPressed;  // For handling M key toggle
     SoundID backgroundMusicID;
     SoundID helicopterSoundID;
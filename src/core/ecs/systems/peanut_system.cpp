@@ -1,24 +1,29 @@
 #include "peanut_system.h"
 #include "../components.h"
 #include "../../engine.h"
+#include "../../job_system.h"
 #include "../../../game/game.h"
 
 void PeanutSystem::Init() {
+    // Collecting boosts the squirrel, kicks the camera and ticks off g_Game's targets
+    DeclareAccess(COMPONENT_TRANSFORM,
+                  COMPONENT_PEANUT | COMPONENT_SPRITE | COMPONENT_SQUIRREL | COMPONENT_CAMERA |
+                  SYSTEM_RESOURCE_AUDIO | SYSTEM_RESOURCE_GAME_STATE);
+    touched.Init();
     printf("PeanutSystem initialized\n");
 }
 
 void PeanutSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
     // Get squirrel components first
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(g_Game.squirrelEntity, COMPONENT_TRANSFORM);
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[g_Game.squirrelEntity];
     SquirrelComponent* squirrel = 
-        (SquirrelComponent*)g_Engine.componentArrays.GetComponentData(g_Game.squirrelEntity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, g_Game.squirrelEntity);
     CameraComponent* camera = 
-        (CameraComponent*)g_Engine.componentArrays.GetComponentData(g_Game.cameraEntity, COMPONENT_CAMERA);
+        g_Engine.componentArrays.Find<CameraComponent>(&g_Engine.entityManager, g_Game.cameraEntity);
     
 
 
-    if (!squirrelTransform || !squirrel) return;
+    if (!squirrel) return;
 
     // Update powerup timers
     if (squirrel->hasShield) {
@@ -36,72 +41,80 @@ void PeanutSystem::Update(float deltaTime, EntityManager* entities, ComponentArr
         }
     }
 
-    // Check for collisions with peanuts
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_PEANUT | COMPONENT_TRANSFORM | COMPONENT_SPRITE)) {
-            PeanutComponent* peanut = &components->peanuts[entity];
-            if (peanut->wasCollected) continue;  // Skip already collected peanuts
-
-            TransformComponent* peanutTransform = &components->transforms[entity];
-            SpriteComponent* peanutSprite = &components->sprites[entity];
+    // Check for collisions with peanuts. The overlap tests are split across
+    // the job threads, collecting stays in view order.
+    EntityView* view = entities->View(COMPONENT_PEANUT | COMPONENT_TRANSFORM | COMPONENT_SPRITE);
+    touched.Reserve(view->dense.count);
+    touched.count = view->dense.count;
+    JobSystem::ParallelFor(view->dense.count, PEANUT_CHECK_CHUNK, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t v = begin; v < end; v++) {
+            EntityID entity = view->dense[v];
+            TransformRef peanutTransform = components->transforms[entity];
+            SpriteRef peanutSprite = components->sprites[entity];
 
             // Simple AABB collision check
-            bool collision = 
+            touched[v] =
                 squirrelTransform->x < peanutTransform->x + peanutSprite->width &&
                 squirrelTransform->x + 32 > peanutTransform->x &&  // assuming squirrel width
                 squirrelTransform->y < peanutTransform->y + peanutSprite->height &&
                 squirrelTransform->y + 32 > peanutTransform->y;   // assuming squirrel height
+        }
+    });
+
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        if (!touched[v]) continue;
+
+        EntityID entity = view->dense[v];
+        PeanutComponent* peanut = &components->peanuts[entity];
+        if (peanut->wasCollected) continue;  // Skip already collected peanuts
+
+        TransformRef peanutTransform = components->transforms[entity];
+        SpriteRef peanutSprite = components->sprites[entity];
+
+        // Apply powerup effect based on type
+        switch (peanut->type) {
+            case PEANUT_TYPE_REGULAR:
+                squirrel->speedBoost += PEANUT_SPEED_BOOST;
+                squirrel->velocityY += PEANUT_SPEED_BOOST*6;
+                squirrel->gravity += SQUIRREL_GRAVITY/5;
+                camera->cameraKick = -150.0f;
+                break;
+
+            case PEANUT_TYPE_SHIELD:
+                squirrel->hasShield = true;
+                squirrel->shieldTimer = PEANUT_SHIELD_DURATION;
+                break;
+
+            case PEANUT_TYPE_SUPER:
+                squirrel->hasSuperMode = true;
+                squirrel->superTimer = PEANUT_SUPER_DURATION;
+                squirrel->speedBoost += PEANUT_SPEED_BOOST * 2;  // Double speed boost for super mode
+                squirrel->hasShield = true;  // Super mode includes shield
+                squirrel->shieldTimer = PEANUT_SUPER_DURATION;
+                break;
+        }
+
+        // Mark peanut as collected and hide its sprite
+        peanut->wasCollected = true;
+        peanutSprite->isVisible = false;  // Hide using sprite component
+        
+        // Play chomp sound
+        ResourceManager::PlaySound(SOUND_CHOMP, 64);  // Half volume (0-128)
+        
+        printf("peanut type %d collected\n", peanut->type);
 
-            if (collision) {
-                // Apply powerup effect based on type
-                switch (peanut->type) {
-                    case PEANUT_TYPE_REGULAR:
-                        squirrel->speedBoost += PEANUT_SPEED_BOOST;
-                        squirrel->velocityY += PEANUT_SPEED_BOOST*6;
-                        squirrel->gravity += SQUIRREL_GRAVITY/5;
-                        camera->cameraKick = -150.0f;
-                        break;
-
-                    case PEANUT_TYPE_SHIELD:
-                        squirrel->hasShield = true;
-                        squirrel->shieldTimer = PEANUT_SHIELD_DURATION;
-                        break;
-
-                    case PEANUT_TYPE_SUPER:
-                        squirrel->hasSuperMode = true;
-                        squirrel->superTimer = PEANUT_SUPER_DURATION;
-                        squirrel->speedBoost += PEANUT_SPEED_BOOST * 2;  // Double speed boost for super mode
-                        squirrel->hasShield = true;  // Super mode includes shield
-                        squirrel->shieldTimer = PEANUT_SUPER_DURATION;
-                        break;
-                }
-
-                // Mark peanut as collected and hide its sprite
-                peanut->wasCollected = true;
-                peanutSprite->isVisible = false;  // Hide using sprite component
-                
-                // Play chomp sound
-                Sound* chompSound = ResourceManager::GetSound(SOUND_CHOMP);
-                if (chompSound) {
-                    chompSound->sdlChunk->volume = 64;  // Half volume (0-128)
-                    Mix_PlayChannel(-1, chompSound->sdlChunk, 0);
-                }
-                
-                printf("peanut type %d collected\n", peanut->type);
-
-                // Update target array
-                for (int i = 0; i < g_Game.numPeanutTargets; i++) {
-                    if (abs(g_Game.peanutTargets[i].x - peanutTransform->x) < 1.0f &&
-                        abs(g_Game.peanutTargets[i].y - peanutTransform->y) < 1.0f) {
-                        g_Game.peanutTargets[i].isCollected = true;
-                        break;
-                    }
-                }
+        // Update target array
+        for (int i = 0; i < g_Game.numPeanutTargets; i++) {
+            if (abs(g_Game.peanutTargets[i].x - peanutTransform->x) < 1.0f &&
+                abs(g_Game.peanutTargets[i].y - peanutTransform->y) < 1.0f) {
+                g_Game.peanutTargets[i].isCollected = true;
+                break;
             }
         }
     }
 }
 
 void PeanutSystem::Destroy() {
+    touched.Destroy();
     printf("PeanutSystem destroyed\n");
 } 
\ No newline at end of file
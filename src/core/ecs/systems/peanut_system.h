@@ -1,9 +1,16 @@
 #pragma once
 #include "../systems.h"
+#include "../paged_array.h"
+
+#define PEANUT_CHECK_CHUNK 256  // Peanuts per ParallelFor job
 
 class PeanutSystem : public System {
 public:
     void Init() override;
     void Update(float deltaTime, EntityManager* entities, ComponentArrays* components) override;
     void Destroy() override;
+
+private:
+    // Set by the parallel overlap pass, indexed like the peanut view
+    GrowableArray<uint8_t> touched;
 }; 
\ No newline at end of file
@@ -1,63 +1,171 @@
 #include "render_system.h"
 #include <stdio.h>
+#include <math.h>
 
 void RenderSystem::Init() {
+    DeclareAccess(COMPONENT_TRANSFORM | COMPONENT_SPRITE | COMPONENT_CAMERA, 0);
     printf("RenderSystem initialized\n");
     cameraX = 0.0f;
     cameraY = 0.0f;
+    spritesSubmitted = 0;
+    spritesCulled = 0;
+    spriteViewVersion = 0;
+    spriteIndexBuilt = false;
+    staticSpriteCount = 0;
+    dynamicSprites.Init();
+    visibleStatic.Init();
+    visibleSetValid = false;
+    queue.Init();
+}
+
+GridBox RenderSystem::GetSpriteBox(float x, float y, float rotation, SpriteRef sprite) {
+    // Sprites are centered on their transform. A rotated sprite can reach as
+    // far as its half diagonal.
+    float halfWidth = sprite->width * 0.5f;
+    float halfHeight = sprite->height * 0.5f;
+    if (rotation != 0.0f) {
+        float radius = sqrtf(halfWidth * halfWidth + halfHeight * halfHeight);
+        halfWidth = radius;
+        halfHeight = radius;
+    }
+
+    GridBox box;
+    box.left = x - halfWidth;
+    box.top = y - halfHeight;
+    box.right = x + halfWidth;
+    box.bottom = y + halfHeight;
+    return box;
+}
+
+void RenderSystem::RebuildSpriteIndex(EntityView* view, ComponentArrays* components) {
+    staticSpriteGrid.Init(RENDER_CULL_CELL_SIZE);
+    staticSpriteCount = 0;
+    dynamicSprites.Clear();
+
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        TransformRef transform = components->transforms[entity];
+        SpriteRef sprite = components->sprites[entity];
+
+        if (sprite->isStatic) {
+            staticSpriteGrid.Insert(entity, GetSpriteBox(transform->x, transform->y, transform->rotation, sprite));
+            staticSpriteCount++;
+        } else {
+            dynamicSprites.Push(entity);
+        }
+    }
+
+    spriteViewVersion = view->version;
+    spriteIndexBuilt = true;
+    visibleSetValid = false;
+}
+
+void RenderSystem::UpdateVisibleSet(const GridBox& viewport) {
+    int minX = (int)floorf(viewport.left / RENDER_CULL_CELL_SIZE);
+    int minY = (int)floorf(viewport.top / RENDER_CULL_CELL_SIZE);
+    int maxX = (int)floorf(viewport.right / RENDER_CULL_CELL_SIZE);
+    int maxY = (int)floorf(viewport.bottom / RENDER_CULL_CELL_SIZE);
+
+    if (visibleSetValid &&
+        minX == visibleCellMinX && minY == visibleCellMinY &&
+        maxX == visibleCellMaxX && maxY == visibleCellMaxY) {
+        return;
+    }
+
+    // Query the whole cell range so the result stays valid while the camera
+    // moves inside it
+    GridBox cells;
+    cells.left = minX * RENDER_CULL_CELL_SIZE;
+    cells.top = minY * RENDER_CULL_CELL_SIZE;
+    cells.right = (maxX + 1) * RENDER_CULL_CELL_SIZE;
+    cells.bottom = (maxY + 1) * RENDER_CULL_CELL_SIZE;
+    // Each static sprite is reported at most once
+    visibleStatic.Reserve(staticSpriteCount);
+    visibleStatic.count = staticSpriteGrid.Query(cells, visibleStatic.data, visibleStatic.capacity);
+
+    visibleCellMinX = minX;
+    visibleCellMinY = minY;
+    visibleCellMaxX = maxX;
+    visibleCellMaxY = maxY;
+    visibleSetValid = true;
+}
+
+void RenderSystem::SubmitSprite(EntityID entity, ComponentArrays* components, const GridBox& viewport, bool cull) {
+    TransformRef transform = components->transforms[entity];
+    SpriteRef sprite = components->sprites[entity];
+
+    if (!sprite->texture || !sprite->isVisible) return;
+
+    // Draw where the sprite is between the last two simulation steps
+    float alpha = g_Engine.interpolationAlpha;
+    float x = transform->InterpolatedX(alpha);
+    float y = transform->InterpolatedY(alpha);
+    float rotation = transform->InterpolatedRotation(alpha);
+
+    if (cull && !SpatialGrid::Overlaps(GetSpriteBox(x, y, rotation, sprite), viewport)) return;
+
+    // Calculate screen position (viewport is at 0,0 without a camera)
+    float screenX = x - viewport.left;
+    float screenY = y - viewport.top;
+
+    SDL_Rect destRect = {
+        (int)screenX - sprite->width/2,
+        (int)screenY - sprite->height/2,
+        sprite->width,
+        sprite->height
+    };
+
+    queue.Submit(sprite->layer, sprite->texture, sprite->srcRect, destRect, rotation);
+    spritesSubmitted++;
 }
 
 void RenderSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
     // Find the active camera (assuming only one camera for now)
     CameraComponent* camera = nullptr;
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_CAMERA)) {
-            camera = &components->cameras[entity];
-            // printf("Active camera found at entity %d\n", entity);
-            break;
-        }
+    EntityView* cameraView = entities->View(COMPONENT_CAMERA);
+    if (cameraView->dense.count > 0) {
+        camera = &components->cameras[cameraView->dense[0]];
     }
 
-    // Render all entities with transform and sprite components
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_TRANSFORM | COMPONENT_SPRITE)) {
-            TransformComponent* transform = 
-                (TransformComponent*)components->GetComponentData(entity, COMPONENT_TRANSFORM);
-            SpriteComponent* sprite = 
-                (SpriteComponent*)components->GetComponentData(entity, COMPONENT_SPRITE);
-
-            if (!transform || !sprite || !sprite->texture || !sprite->isVisible) continue;
-
-            // Calculate screen position (with camera offset if camera exists)
-            float screenX = transform->x;
-            float screenY = transform->y;
-            
-            if (camera) {
-                screenX -= camera->x;
-                screenY -= camera->y;
-            }
+    EntityView* view = entities->View(COMPONENT_TRANSFORM | COMPONENT_SPRITE);
+    if (!spriteIndexBuilt || spriteViewVersion != view->version) {
+        RebuildSpriteIndex(view, components);
+    }
+
+    spritesSubmitted = 0;
+    queue.Begin();
+
+    GridBox viewport = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (camera) {
+        float alpha = g_Engine.interpolationAlpha;
+        viewport.left = camera->InterpolatedX(alpha);
+        viewport.top = camera->InterpolatedY(alpha);
+        viewport.right = viewport.left + camera->viewportWidth;
+        viewport.bottom = viewport.top + camera->viewportHeight;
+        UpdateVisibleSet(viewport);
 
-            SDL_Rect destRect = {
-                (int)screenX - sprite->width/2,
-                (int)screenY - sprite->height/2,
-                sprite->width,
-                sprite->height
-            };
-
-            SDL_RenderCopyEx(
-                g_Engine.window->renderer,
-                sprite->texture->sdlTexture,
-                &sprite->srcRect,
-                &destRect,
-                transform->rotation,
-                NULL,
-                SDL_FLIP_NONE
-            );
+        for (uint32_t i = 0; i < visibleStatic.count; i++) {
+            SubmitSprite(visibleStatic[i], components, viewport, true);
         }
+    } else {
+        // No camera, nothing to cull against
+        for (uint32_t v = 0; v < view->dense.count; v++) {
+            if (components->sprites[view->dense[v]].isStatic) {
+                SubmitSprite(view->dense[v], components, viewport, false);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < dynamicSprites.count; i++) {
+        SubmitSprite(dynamicSprites[i], components, viewport, camera != nullptr);
     }
+
+    spritesCulled = staticSpriteCount + dynamicSprites.count - spritesSubmitted;
+
+    queue.Flush(g_Engine.window->renderer);
 }
 
-void RenderSystem::RenderEntity(TransformComponent* transform, SpriteComponent* sprite) {
+void RenderSystem::RenderEntity(TransformRef transform, SpriteRef sprite) {
     if (!sprite->texture || !sprite->texture->sdlTexture) return;
 
     // Calculate screen position (applying camera offset)
@@ -72,7 +180,7 @@ void RenderSystem::RenderEntity(TransformComponent* transform, SpriteComponent*
     destRect.h = sprite->height * transform->scale;
     
     // Create source rectangle (for sprite sheets)
-    SDL_Rect* srcRect = (sprite->srcRect.w > 0) ? &sprite->srcRect : NULL;
+    SDL_Rect* srcRect = (sprite->srcRect.w > 0) ? &sprite->srcRect : &sprite->texture->atlasRect;
     
     // Calculate rotation center
     SDL_Point center = {
@@ -92,38 +200,10 @@ void RenderSystem::RenderEntity(TransformComponent* transform, SpriteComponent*
     );
 }
 
-void RenderSystem::RenderAnimatedEntity(TransformComponent* transform, AnimationComponent* anim) {
-    if (!anim->spriteSheet || !anim->spriteSheet->sdlTexture) return;
-
-    // Calculate screen position (applying camera offset)
-    int screenX = (int)(transform->x - cameraX);
-    int screenY = (int)(transform->y - cameraY);
-    
-    // Create destination rectangle
-    SDL_Rect destRect;
-    destRect.x = screenX;
-    destRect.y = screenY;
-    destRect.w = anim->frameWidth * transform->scale;
-    destRect.h = anim->frameHeight * transform->scale;
-    
-    // Calculate rotation center
-    SDL_Point center = {
-        (int)(anim->frameWidth * transform->scale / 2),
-        (int)(anim->frameHeight * transform->scale / 2)
-    };
-    
-    // Render the sprite
-    SDL_RenderCopyEx(
-        g_Engine.window->renderer,
-        anim->spriteSheet->sdlTexture,
-        &anim->frameRect,
-        &destRect,
-        transform->rotation,
-        &center,
-        SDL_FLIP_NONE
-    );
-}
-
 void RenderSystem::Destroy() {
+    queue.Destroy();
+    staticSpriteGrid.Destroy();
+    dynamicSprites.Destroy();
+    visibleStatic.Destroy();
     printf("RenderSystem destroyed\n");
 } 
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "../systems.h"
 #include "../../window.h"
 #include "../../engine.h"
+#include "../../spatial_grid.h"
+#include "../../render_queue.h"
+
+#define RENDER_CULL_CELL_SIZE 256.0f  // Cell size of the static sprite grid, in px
 
 struct RenderSystem : System {
     void Init() override;
@@ -12,7 +16,33 @@ struct RenderSystem : System {
     float cameraX = 0.0f;
     float cameraY = 0.0f;
 
+    // Per-frame counters: sprites drawn, and sprites skipped because they were
+    // outside the camera (or hidden)
+    int spritesSubmitted;
+    int spritesCulled;
+
+    // Sprites are queued during Update and drawn in texture batches at the end
+    RenderQueue queue;
+
 private:
-    void RenderEntity(TransformComponent* transform, SpriteComponent* sprite);
-    void RenderAnimatedEntity(TransformComponent *transform, AnimationComponent *anim);
-};
\ No newline at end of file
+    // Static sprites live in a grid that is only rebuilt when the sprite view
+    // changes. Dynamic sprites are few and culled one by one.
+    SpatialGrid staticSpriteGrid;
+    uint32_t spriteViewVersion;
+    bool spriteIndexBuilt;
+    int staticSpriteCount;
+    GrowableArray<EntityID> dynamicSprites;
+
+    // Static sprites near the camera, reused until the camera crosses into a
+    // different range of grid cells
+    GrowableArray<uint32_t> visibleStatic;
+    int visibleCellMinX, visibleCellMinY, visibleCellMaxX, visibleCellMaxY;
+    bool visibleSetValid;
+
+    void RebuildSpriteIndex(EntityView* view, ComponentArrays* components);
+    void UpdateVisibleSet(const GridBox& viewport);
+    void SubmitSprite(EntityID entity, ComponentArrays* components, const GridBox& viewport, bool cull);
+    static GridBox GetSpriteBox(float x, float y, float rotation, SpriteRef sprite);
+
+    void RenderEntity(TransformRef transform, SpriteRef sprite);
+};
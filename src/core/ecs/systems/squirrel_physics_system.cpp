@@ -6,40 +6,38 @@
 
 
 void SquirrelPhysicsSystem::Init() {
-    // Nothing to initialize
+    // Changes the sprite along with the state
+    DeclareAccess(0, COMPONENT_TRANSFORM | COMPONENT_SQUIRREL | COMPONENT_SPRITE);
 }
 
 void SquirrelPhysicsSystem::Update(float deltaTime, EntityManager* entities, ComponentArrays* components) {
-    for (EntityID entity = 1; entity < MAX_ENTITIES; entity++) {
-        if (entities->HasComponent(entity, COMPONENT_TRANSFORM | COMPONENT_SQUIRREL | COMPONENT_SPRITE)) {
-            SquirrelComponent* squirrel = 
-                (SquirrelComponent*)components->GetComponentData(entity, COMPONENT_SQUIRREL);
-            TransformComponent* transform = 
-                (TransformComponent*)components->GetComponentData(entity, COMPONENT_TRANSFORM);
-            SpriteComponent* sprite =
-                (SpriteComponent*)components->GetComponentData(entity, COMPONENT_SPRITE);
-
-            // Handle all state-related logic in one place
-            HandleSquirrelState(squirrel, sprite, deltaTime);
-            HandleMovementInput(squirrel, deltaTime);
-
-            // Apply physics
-            ApplyGravity(squirrel, deltaTime);
-            LimitVerticalSpeed(squirrel);
-
-            // Update position
-            if(squirrel->state != SQUIRREL_STATE_DROPPING) {
-                transform->x += squirrel->velocityX * deltaTime;
-                transform->y += squirrel->velocityY * deltaTime;
-            }
+    EntityView* view = entities->View(COMPONENT_TRANSFORM | COMPONENT_SQUIRREL | COMPONENT_SPRITE);
+    for (uint32_t v = 0; v < view->dense.count; v++) {
+        EntityID entity = view->dense[v];
+        SquirrelComponent* squirrel = &components->Get<SquirrelComponent>(entity);
+        TransformRef transform = components->transforms[entity];
+        SpriteRef sprite = components->sprites[entity];
+
+        // Handle all state-related logic in one place
+        HandleSquirrelState(squirrel, sprite, deltaTime);
+        HandleMovementInput(squirrel, deltaTime);
+
+        // Apply physics
+        ApplyGravity(squirrel, deltaTime);
+        LimitVerticalSpeed(squirrel, deltaTime);
+
+        // Update position
+        if(squirrel->state != SQUIRREL_STATE_DROPPING) {
+            transform->x += squirrel->velocityX * deltaTime;
+            transform->y += squirrel->velocityY * deltaTime;
+        }
 
-            // Keep rotation at zero (except for wiggle state)
-            if (squirrel->state == SQUIRREL_STATE_WIGGLING) {
-                float wiggleAngle = 30.0f * sinf(squirrel->wiggleTimer * 15.0f);
-                transform->rotation = wiggleAngle;
-            } else {
-                transform->rotation = 0;
-            }
+        // Keep rotation at zero (except for wiggle state)
+        if (squirrel->state == SQUIRREL_STATE_WIGGLING) {
+            float wiggleAngle = 30.0f * sinf(squirrel->wiggleTimer * 15.0f);
+            transform->rotation = wiggleAngle;
+        } else {
+            transform->rotation = 0;
         }
     }
 }
@@ -87,19 +85,21 @@ void SquirrelPhysicsSystem::ApplyGravity(SquirrelComponent* squirrel, float delt
     squirrel->velocityY += squirrel->currentGravity * deltaTime;
 }
 
-void SquirrelPhysicsSystem::LimitVerticalSpeed(SquirrelComponent* squirrel) {
+void SquirrelPhysicsSystem::LimitVerticalSpeed(SquirrelComponent* squirrel, float deltaTime) {
     
     if (fabsf(squirrel->velocityY) > squirrel->maxSpeed) {
         float targetSpeed = squirrel->maxSpeed * (squirrel->velocityY > 0 ? 1.0f : -1.0f);
-        // Lerp between current velocity and target speed
-        squirrel->velocityY = squirrel->velocityY + (targetSpeed - squirrel->velocityY) * SMOOTHING_FACTOR;
+        // Lerp between current velocity and target speed. SMOOTHING_FACTOR was
+        // tuned per 60Hz frame, scale it so any step size converges the same.
+        float smoothing = 1.0f - powf(1.0f - SMOOTHING_FACTOR, deltaTime * REFERENCE_FRAME_RATE);
+        squirrel->velocityY = squirrel->velocityY + (targetSpeed - squirrel->velocityY) * smoothing;
     }
 }
 
 void SquirrelPhysicsSystem::Destroy() {}
 
 void SquirrelPhysicsSystem::HandleSquirrelState(SquirrelComponent* squirrel, 
-                                               SpriteComponent* sprite, 
+                                               SpriteRef sprite, 
                                                float deltaTime) {
     // Handle state timers first
     if (squirrel->state == SQUIRREL_STATE_WIGGLING) {
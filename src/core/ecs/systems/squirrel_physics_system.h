@@ -14,15 +14,15 @@ struct SquirrelPhysicsSystem : System {
     void Update(float deltaTime, EntityManager *entities, ComponentArrays *components) override;
     void HandleMovementInput(SquirrelComponent *squirrel, float deltaTime);
     void ApplyGravity(SquirrelComponent *squirrel, float deltaTime);
-    void LimitVerticalSpeed(SquirrelComponent *squirrel);
-    void UpdateRotation(SquirrelComponent *squirrel, TransformComponent *transform, float deltaTime);
+    void LimitVerticalSpeed(SquirrelComponent *squirrel, float deltaTime);
+    void UpdateRotation(SquirrelComponent *squirrel, TransformRef transform, float deltaTime);
 
 private:
     void UpdateVelocity(SquirrelComponent* squirrel, float deltaTime);
     void ApplyMaxSpeed(SquirrelComponent* squirrel);
     void HandleRotationInput(SquirrelComponent* squirrel);
-    void HandleStateInput(SquirrelComponent *squirrel, SpriteComponent *sprite);
-    void HandleSquirrelState(SquirrelComponent *squirrel, SpriteComponent *sprite, float deltaTime);
+    void HandleStateInput(SquirrelComponent *squirrel, SpriteRef sprite);
+    void HandleSquirrelState(SquirrelComponent *squirrel, SpriteRef sprite, float deltaTime);
 };
 
 #endif 
\ No newline at end of file
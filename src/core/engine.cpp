@@ -2,12 +2,25 @@
 #include "../game/game.h"
 #include "window.h"
 #include "input.h"
+#include "profiler.h"
+#include "input_recorder.h"
+#include "job_system.h"
 #include <stdio.h>
+#include <algorithm>
+#include <math.h>
 
 // Global engine instance
 Engine g_Engine;
 
-bool Engine::Init() {
+bool Engine::Init(FrameMode frameMode, int targetFps, int workerThreads) {
+#ifdef HEADLESS
+    // No window, renderer or audio device. Only SDL's timers are used.
+    if (SDL_Init(0) < 0) {
+        printf("SDL initialization failed! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+    g_Engine.window = nullptr;
+#else
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         printf("SDL initialization failed! SDL Error: %s\n", SDL_GetError());
@@ -37,9 +50,13 @@ bool Engine::Init() {
 
     // Create window
     g_Engine.window = new Window();
-    if (!g_Engine.window->Init("RoseEngine", WINDOW_WIDTH, WINDOW_HEIGHT)) {
+    if (!g_Engine.window->Init("RoseEngine", WINDOW_WIDTH, WINDOW_HEIGHT, frameMode == FRAME_MODE_VSYNC)) {
         return false;
     }
+#endif
+
+    // Started first, the assets decode on it
+    JobSystem::Init(workerThreads);
 
     if (!ResourceManager::InitAllResources()) {
         // error is handled inside function call
@@ -47,8 +64,12 @@ bool Engine::Init() {
     }
 
     g_Engine.isRunning = true;
-    g_Engine.lastFrameTime = SDL_GetTicks();
+    g_Engine.framePacer.Init(frameMode, targetFps);
     g_Engine.deltaTime = 0.0f;
+    g_Engine.accumulator = 0.0f;
+    g_Engine.interpolationAlpha = 1.0f;
+    g_Engine.timeScale = 1.0f;
+    g_Engine.profileCsvPath = nullptr;
 
     // Initialize engine systems
     g_Engine.entityManager.Init();
@@ -64,85 +85,247 @@ static void emscripten_loop() {
 }
 #endif
 
+// Remembers where everything was before a step, for render interpolation
+static void SavePreviousTransforms() {
+    // Whole field arrays at once, cheaper than walking the transform view
+    g_Engine.componentArrays.transforms.SavePreviousAll();
+
+    EntityView* cameraView = g_Engine.entityManager.View(COMPONENT_CAMERA);
+    for (uint32_t v = 0; v < cameraView->dense.count; v++) {
+        g_Engine.componentArrays.cameras[cameraView->dense[v]].SavePrevious();
+    }
+}
+
+void Engine::StepSimulation(float dt) {
+    SavePreviousTransforms();
+    {
+        PROFILE_SCOPE("Game::Update");
+        g_Game.Update(dt);
+    }
+
+    // Only the first step of a frame sees pressed/released edges
+    Input::ClearEdges();
+}
+
+void Engine::AdvanceSimulation(float simulatedTime) {
+    // Run as many fixed steps as the elapsed time covers
+    g_Engine.accumulator += simulatedTime;
+    float maxAccumulated = FIXED_TIMESTEP * MAX_FIXED_STEPS * std::max(1.0f, g_Engine.timeScale);
+    if (g_Engine.accumulator > maxAccumulated) {
+        g_Engine.accumulator = maxAccumulated;
+    }
+    while (g_Engine.accumulator >= FIXED_TIMESTEP) {
+        g_Engine.StepSimulation(FIXED_TIMESTEP);
+        g_Engine.accumulator -= FIXED_TIMESTEP;
+    }
+    g_Engine.interpolationAlpha = g_Engine.accumulator / FIXED_TIMESTEP;
+}
+
+// FNV-1a over every transform, in entity order. Two runs that end with the
+// same hash ended in the same place.
+static Uint32 HashSimulationState() {
+    Uint32 hash = 2166136261u;
+    for (uint32_t index = 1; index <= g_Engine.entityManager.highestIndex; index++) {
+        // Masks are cleared on destroy, so freed slots drop out here too
+        if (!(g_Engine.entityManager.componentMasks[index] & COMPONENT_TRANSFORM)) continue;
+
+        TransformRef transform = g_Engine.componentArrays.transforms[index];
+        float values[3] = { transform->x, transform->y, transform->rotation };
+        const Uint8* bytes = (const Uint8*)values;
+        for (size_t i = 0; i < sizeof(values); i++) {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+void Engine::FinishInputLog() {
+    InputRecorder::Finish(HashSimulationState());
+}
+
 void Engine::RunFrame() {
+    // Measure the time since the last frame started
+    g_Engine.deltaTime = g_Engine.framePacer.BeginFrame();
+    Profiler::BeginFrame();
 
     // Update input state
     Input::Update();
 
+    // Simulated time this frame, a replay swaps in the recorded value
+    float simulatedTime = g_Engine.deltaTime * g_Engine.timeScale;
+
     // Handle events
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                g_Engine.isRunning = false;
-                break;
+    {
+        PROFILE_SCOPE("Events");
+        bool replaying = InputRecorder::IsReplaying();
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            switch (event.type) {
+                case SDL_QUIT:
+                    g_Engine.isRunning = false;
+                    break;
                 
-            case SDL_KEYDOWN:
-                Input::keys[event.key.keysym.scancode] = true;
-                Input::keysPressed[event.key.keysym.scancode] = true;
-                break;
+                case SDL_KEYDOWN:
+                    // The profiler overlay is engine-level, toggle it right away
+                    if (event.key.keysym.scancode == SDL_SCANCODE_F3 && !event.key.repeat) {
+                        Profiler::showOverlay = !Profiler::showOverlay;
+                    }
+                    if (replaying) break;  // Game input comes from the log
+                    Input::SetKey(event.key.keysym.scancode, true);
+                    InputRecorder::RecordEvent(INPUT_EVENT_KEY_DOWN, event.key.keysym.scancode);
+                    break;
                 
-            case SDL_KEYUP:
-                Input::keys[event.key.keysym.scancode] = false;
-                Input::keysReleased[event.key.keysym.scancode] = true;
-                break;
+                case SDL_KEYUP:
+                    if (replaying) break;
+                    Input::SetKey(event.key.keysym.scancode, false);
+                    InputRecorder::RecordEvent(INPUT_EVENT_KEY_UP, event.key.keysym.scancode);
+                    break;
                 
-            case SDL_MOUSEBUTTONDOWN:
-                Input::mouseButtons[event.button.button - 1] = true;
-                Input::mouseButtonsPressed[event.button.button - 1] = true;
-                break;
+                case SDL_MOUSEBUTTONDOWN:
+                    if (replaying) break;
+                    Input::SetMouseButton(event.button.button, true);
+                    InputRecorder::RecordEvent(INPUT_EVENT_MOUSE_DOWN, event.button.button);
+                    break;
                 
-            case SDL_MOUSEBUTTONUP:
-                Input::mouseButtons[event.button.button - 1] = false;
-                Input::mouseButtonsReleased[event.button.button - 1] = true;
-                break;
+                case SDL_MOUSEBUTTONUP:
+                    if (replaying) break;
+                    Input::SetMouseButton(event.button.button, false);
+                    InputRecorder::RecordEvent(INPUT_EVENT_MOUSE_UP, event.button.button);
+                    break;
+            }
+        }
+
+        if (replaying) {
+            if (!InputRecorder::ReplayFrame(&simulatedTime)) {
+                // Log is used up, stop on the exact recorded state
+                simulatedTime = 0.0f;
+                g_Engine.isRunning = false;
+            }
+        } else {
+            InputRecorder::EndRecordFrame(simulatedTime);
         }
     }
 
     // Clear screen
     g_Engine.window->Clear();
 
-    // Update and render game
-    g_Game.Update(g_Engine.deltaTime);
-    g_Game.Render();
+    g_Engine.AdvanceSimulation(simulatedTime);
 
-    // Present screen
-    g_Engine.window->Present();
+    // Render game
+    {
+        PROFILE_SCOPE("Game::Render");
+        g_Game.Render();
+    }
+    Profiler::DrawOverlay(10, 10);
 
-    // Calculate delta time
-    Uint32 currentTime = SDL_GetTicks();
-    g_Engine.deltaTime = (currentTime - g_Engine.lastFrameTime) / 1000.0f;
-    g_Engine.lastFrameTime = currentTime;
+    // Present screen
+    {
+        PROFILE_SCOPE("Present");
+        g_Engine.window->Present();
+    }
 
-    // Cap framerate
-    Uint32 frameTime = SDL_GetTicks() - currentTime;
-    if (frameTime < FRAME_TIME) {
-        SDL_Delay(FRAME_TIME - frameTime);
+    // Wait out the rest of the frame when capped
+    {
+        PROFILE_SCOPE("Frame wait");
+        g_Engine.framePacer.EndFrame();
     }
+
+    Profiler::EndFrame();
 }
 
 void Engine::Run() {
 #ifdef __EMSCRIPTEN__
-    // Set up the loop
-    emscripten_set_main_loop(emscripten_loop, 0, 1);
+    // Set up the loop. 0 follows requestAnimationFrame, which is the
+    // browser's vsync; a capped pacer asks for its own rate instead.
+    int fps = g_Engine.framePacer.mode == FRAME_MODE_CAPPED ? g_Engine.framePacer.targetFps : 0;
+    emscripten_set_main_loop(emscripten_loop, fps, 1);
 
 #else
     while (g_Engine.isRunning) {
         g_Engine.RunFrame();
     }
+    g_Engine.FinishInputLog();
 #endif
 }
 
+// Holds a key down and sets its pressed/released edges like the event pump would
+static void SetScriptedKey(SDL_Scancode key, bool down) {
+    if (Input::keys[key] == down) return;
+    Input::SetKey(key, down);
+    InputRecorder::RecordEvent(down ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP, key);
+}
+
+// Deterministic stand-in for a player: flaps the arms, weaves left and right
+// and restarts once the squirrel reaches the bottom
+static void ApplyScriptedInput(float simTime) {
+    SetScriptedKey(SDL_SCANCODE_SPACE, fmodf(simTime, 3.0f) < 1.5f);
+
+    bool goLeft = fmodf(simTime, 4.0f) < 2.0f;
+    SetScriptedKey(SDL_SCANCODE_LEFT, goLeft);
+    SetScriptedKey(SDL_SCANCODE_RIGHT, !goLeft);
+
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[g_Game.squirrelEntity];
+    SetScriptedKey(SDL_SCANCODE_R, squirrelTransform->y >= GAME_HEIGHT + 400);
+}
+
+void Engine::RunHeadless(int frames) {
+    printf("Running %d headless frames at %.0f Hz\n", frames, 1.0f / FIXED_TIMESTEP);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    double simulatedSeconds = 0.0;
+    int frame = 0;
+    for (; frame < frames && g_Engine.isRunning; frame++) {
+        Profiler::BeginFrame();
+
+        float simulatedTime = FIXED_TIMESTEP;
+        if (InputRecorder::IsReplaying()) {
+            // Recorded sessions play back their own input and frame times
+            if (!InputRecorder::ReplayFrame(&simulatedTime)) {
+                Profiler::EndFrame();
+                break;
+            }
+        } else {
+            ApplyScriptedInput(frame * FIXED_TIMESTEP);
+            InputRecorder::EndRecordFrame(simulatedTime);
+        }
+
+        g_Engine.deltaTime = simulatedTime;
+        g_Engine.AdvanceSimulation(simulatedTime);
+        simulatedSeconds += simulatedTime;
+        Profiler::EndFrame();
+    }
+    frames = frame;
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)frequency;
+    printf("Simulated %d frames (%.1f s of game time) in %.3f s\n", frames, simulatedSeconds, seconds);
+    printf("%.0f simulated frames per second, %.1fx real time, %.4f ms per frame\n",
+        frames / seconds, simulatedSeconds / seconds, seconds * 1000.0 / frames);
+
+    g_Engine.FinishInputLog();
+}
+
 void Engine::Cleanup() {
+    if (g_Engine.profileCsvPath) {
+        Profiler::WriteCSV(g_Engine.profileCsvPath);
+    }
+
     ResourceManager::UnloadAllResources();
 
+    JobSystem::Destroy();
+    g_Engine.componentArrays.Destroy();
+    g_Engine.entityManager.Destroy();
+
     if (g_Engine.window) {
         g_Engine.window->Cleanup();
         delete g_Engine.window;
     }
 
 
+#ifndef HEADLESS
     TTF_Quit();
     IMG_Quit();
+#endif
     SDL_Quit();
 } 
\ No newline at end of file
@@ -1,16 +1,22 @@
 #pragma once
 
 #include <SDL.h>
+#ifndef HEADLESS
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#endif
 #include <stdio.h>
 #include "resource_manager.h"
 #include "ecs/systems.h"
 #include "ecs/components.h"
 #include "ecs/entity.h"
 #include "ecs/entity_test.h"
+#include "ecs/collision_test.h"
+#include "spatial_grid_bench.h"
+#include "ecs/component_layout_bench.h"
 #include "engine_constants.h"
+#include "frame_pacer.h"
 
 // #include "window.h"
 
@@ -28,8 +34,14 @@ class Game;
 // Core engine systems
 struct Engine {
     bool isRunning;
-    float deltaTime;
-    Uint32 lastFrameTime;
+    float deltaTime;         // Real time of the last frame, in seconds
+    FramePacer framePacer;
+
+    // Fixed-step simulation
+    float accumulator;       // Unsimulated time carried to the next frame
+    float interpolationAlpha;// How far rendering is between the last two steps (0..1)
+    float timeScale;         // Simulated seconds per real second, >1 runs faster than real time
+    const char* profileCsvPath; // --profile-csv, the profiler stats are written there on exit
     
     // Core systems
     Window* window;
@@ -38,16 +50,28 @@ struct Engine {
     SystemManager systemManager;
     ComponentArrays componentArrays;
     
-    // Initialize the engine
-    static bool Init();
+    // Initialize the engine. targetFps only matters in FRAME_MODE_CAPPED.
+    // workerThreads -1 starts one per core besides the main thread, 0 runs
+    // every system on the main thread.
+    static bool Init(FrameMode frameMode = FRAME_MODE_VSYNC, int targetFps = TARGET_FPS, int workerThreads = -1);
     
     // Cleanup the engine
     static void Cleanup();
 
     void RunFrame();
+    void StepSimulation(float dt);
+    // Adds simulatedTime to the accumulator and runs the fixed steps it covers
+    void AdvanceSimulation(float simulatedTime);
+    // Closes an input recording or checks a replay against it
+    void FinishInputLog();
 
     // Main loop
     void Run();
+
+    // Steps the simulation frames times as fast as possible with scripted
+    // input, or the replayed input log, and prints the simulated frame rate.
+    // Nothing is drawn.
+    void RunHeadless(int frames);
 };
 
 extern Engine g_Engine;  // Global engine instance
@@ -1,8 +1,10 @@
 #pragma once
 
 // Core engine constants
-#define TARGET_FPS 60
-#define FRAME_TIME (1000.0f / TARGET_FPS)
+#define TARGET_FPS 60  // Default rate for FRAME_MODE_CAPPED
+#define FIXED_TIMESTEP (1.0f / 120.0f)  // Simulation step, in seconds
+#define MAX_FIXED_STEPS 8               // Per frame, drops time instead of spiralling after a hitch
+#define REFERENCE_FRAME_RATE 60.0f      // Rate the old per-frame tuning constants were made for
 #define WINDOW_HEIGHT 800
 #define WINDOW_WIDTH 800
 #define GAME_WIDTH (WINDOW_WIDTH * 3)    // 3 windows wide
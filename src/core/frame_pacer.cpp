@@ -0,0 +1,74 @@
+#include "frame_pacer.h"
+#include <stdio.h>
+
+void FramePacer::Init(FrameMode frameMode, int fps) {
+    mode = frameMode;
+    targetFps = fps > 0 ? fps : 60;
+    frequency = SDL_GetPerformanceFrequency();
+    period = frequency / targetFps;
+    lastCounter = SDL_GetPerformanceCounter();
+    nextDeadline = lastCounter + period;
+
+    if (mode == FRAME_MODE_CAPPED) {
+        printf("Frame pacer: %s at %d fps\n", FrameModeName(mode), targetFps);
+    } else {
+        printf("Frame pacer: %s\n", FrameModeName(mode));
+    }
+}
+
+float FramePacer::BeginFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double seconds = (double)(now - lastCounter) / (double)frequency;
+    lastCounter = now;
+
+    if (seconds > FRAME_PACER_MAX_DELTA) seconds = FRAME_PACER_MAX_DELTA;
+    return (float)seconds;
+}
+
+void FramePacer::EndFrame() {
+    if (mode != FRAME_MODE_CAPPED) return;
+
+#ifndef __EMSCRIPTEN__
+    // The browser schedules our frames, blocking here would only stall it
+    WaitUntil(nextDeadline);
+#endif
+
+    // Step the deadline by whole periods so rounding doesn't drift the rate.
+    // If we fell more than a frame behind, start over from now instead of
+    // rushing to catch up.
+    Uint64 now = SDL_GetPerformanceCounter();
+    nextDeadline += period;
+    if (now > nextDeadline) {
+        nextDeadline = now + period;
+    }
+}
+
+void FramePacer::WaitUntil(Uint64 deadline) {
+    Uint64 spinMargin = (Uint64)(FRAME_PACER_SPIN_MARGIN * frequency);
+
+    for (;;) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now >= deadline) return;
+
+        Uint64 remaining = deadline - now;
+        if (remaining > spinMargin) {
+            // Sleep for the bulk of it, leaving the margin to absorb oversleep
+            Uint32 sleepMs = (Uint32)((remaining - spinMargin) * 1000 / frequency);
+            SDL_Delay(sleepMs > 0 ? sleepMs : 1);
+        } else {
+            // Close enough to spin to the deadline
+            while (SDL_GetPerformanceCounter() < deadline) {
+            }
+            return;
+        }
+    }
+}
+
+const char* FrameModeName(FrameMode mode) {
+    switch (mode) {
+        case FRAME_MODE_VSYNC: return "vsync";
+        case FRAME_MODE_CAPPED: return "capped";
+        case FRAME_MODE_UNCAPPED: return "uncapped";
+    }
+    return "unknown";
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL.h>
+
+#define FRAME_PACER_SPIN_MARGIN 0.002  // Seconds before the deadline to stop sleeping and spin
+#define FRAME_PACER_MAX_DELTA 0.25     // Longest frame reported, so breakpoints don't explode dt
+
+enum FrameMode {
+    FRAME_MODE_VSYNC,     // Present blocks on the display, no extra waiting
+    FRAME_MODE_CAPPED,    // No vsync, wait out the rest of each frame ourselves
+    FRAME_MODE_UNCAPPED   // No vsync, no waiting
+};
+
+// Measures frame time with the performance counter and, when capped, waits
+// until the next frame deadline. Waiting sleeps while there's plenty of time
+// left (SDL_Delay is only good to a millisecond or so) and spins the rest.
+struct FramePacer {
+    FrameMode mode;
+    int targetFps;
+    Uint64 frequency;     // Counter ticks per second
+    Uint64 period;        // Counter ticks per frame when capped
+    Uint64 lastCounter;   // Start of the previous frame
+    Uint64 nextDeadline;  // When the current frame should end
+
+    void Init(FrameMode frameMode, int fps);
+
+    // Call once at the start of each frame. Returns seconds since the last call.
+    float BeginFrame();
+
+    // Call once after presenting, waits for the deadline in capped mode
+    void EndFrame();
+
+    bool UsesVSync() const { return mode == FRAME_MODE_VSYNC; }
+
+private:
+    void WaitUntil(Uint64 deadline);
+};
+
+const char* FrameModeName(FrameMode mode);
@@ -23,14 +23,39 @@ void Input::Init() {
 }
 
 void Input::Update() {
-    // Clear per-frame states
+    // Get mouse position
+    SDL_GetMouseState(&mouseX, &mouseY);
+}
+
+void Input::SetKey(SDL_Scancode key, bool down) {
+    if (key < 0 || key >= SDL_NUM_SCANCODES) return;
+
+    keys[key] = down;
+    if (down) {
+        keysPressed[key] = true;
+    } else {
+        keysReleased[key] = true;
+    }
+}
+
+void Input::SetMouseButton(int button, bool down) {
+    if (button < 1 || button > 5) return;
+
+    mouseButtons[button - 1] = down;
+    if (down) {
+        mouseButtonsPressed[button - 1] = true;
+    } else {
+        mouseButtonsReleased[button - 1] = true;
+    }
+}
+
+// Edges are kept until a fixed step runs, so a press on a frame without a
+// simulation step isn't lost, and the first step that runs eats it
+void Input::ClearEdges() {
     memset(keysPressed, 0, sizeof(keysPressed));
     memset(keysReleased, 0, sizeof(keysReleased));
     memset(mouseButtonsPressed, 0, sizeof(mouseButtonsPressed));
     memset(mouseButtonsReleased, 0, sizeof(mouseButtonsReleased));
-    
-    // Get mouse position
-    SDL_GetMouseState(&mouseX, &mouseY);
 }
 
 void Input::Clear() {
@@ -19,6 +19,13 @@ struct Input {
     
     // Update input states
     static void Update();
+
+    // Apply a key or mouse button (SDL numbering, 1 = left) going down or up
+    static void SetKey(SDL_Scancode key, bool down);
+    static void SetMouseButton(int button, bool down);
+
+    // Clear pressed/released edges once the simulation has seen them
+    static void ClearEdges();
     
     // Clear per-frame states
     static void Clear();
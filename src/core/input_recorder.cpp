@@ -0,0 +1,145 @@
+#include "input_recorder.h"
+#include "input.h"
+#include <string.h>
+
+InputRecorderMode InputRecorder::mode = INPUT_RECORDER_OFF;
+FILE* InputRecorder::file = nullptr;
+Uint32 InputRecorder::frameCount = 0;
+bool InputRecorder::reachedEnd = false;
+Uint32 InputRecorder::expectedHash = 0;
+Uint16 InputRecorder::frameEvents[MAX_FRAME_INPUT_EVENTS];
+int InputRecorder::frameEventCount = 0;
+
+bool InputRecorder::StartRecording(const char* path, float timeScale, Uint32 levelSeed) {
+    file = fopen(path, "wb");
+    if (!file) {
+        printf("Failed to open input log %s for writing\n", path);
+        return false;
+    }
+
+    Uint32 version = INPUT_LOG_VERSION;
+    fwrite(INPUT_LOG_MAGIC, 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(&timeScale, sizeof(timeScale), 1, file);
+    fwrite(&levelSeed, sizeof(levelSeed), 1, file);
+
+    mode = INPUT_RECORDER_RECORD;
+    frameCount = 0;
+    frameEventCount = 0;
+    printf("Recording input to %s\n", path);
+    return true;
+}
+
+bool InputRecorder::StartReplay(const char* path, float* timeScale, Uint32* levelSeed) {
+    file = fopen(path, "rb");
+    if (!file) {
+        printf("Failed to open input log %s\n", path);
+        return false;
+    }
+
+    char magic[4];
+    Uint32 version = 0;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, INPUT_LOG_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(version), 1, file) != 1 || version < 1 || version > INPUT_LOG_VERSION ||
+        fread(timeScale, sizeof(*timeScale), 1, file) != 1 ||
+        (version >= 2 && fread(levelSeed, sizeof(*levelSeed), 1, file) != 1)) {
+        printf("%s is not a version 1-%d input log\n", path, INPUT_LOG_VERSION);
+        fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    mode = INPUT_RECORDER_REPLAY;
+    frameCount = 0;
+    reachedEnd = false;
+    printf("Replaying input from %s\n", path);
+    return true;
+}
+
+void InputRecorder::RecordEvent(InputEventType type, int code) {
+    if (mode != INPUT_RECORDER_RECORD) return;
+
+    if (frameEventCount >= MAX_FRAME_INPUT_EVENTS) {
+        printf("Warning: Too many input events in one frame, dropping one\n");
+        return;
+    }
+    frameEvents[frameEventCount++] = (Uint16)((type << 12) | (code & 0x0FFF));
+}
+
+void InputRecorder::EndRecordFrame(float dt) {
+    if (mode != INPUT_RECORDER_RECORD) return;
+
+    Uint8 eventCount = (Uint8)frameEventCount;
+    fwrite(&eventCount, sizeof(eventCount), 1, file);
+    fwrite(&dt, sizeof(dt), 1, file);
+    fwrite(frameEvents, sizeof(Uint16), frameEventCount, file);
+
+    frameEventCount = 0;
+    frameCount++;
+}
+
+bool InputRecorder::ReplayFrame(float* dt) {
+    if (mode != INPUT_RECORDER_REPLAY || reachedEnd) return false;
+
+    Uint8 eventCount;
+    if (fread(&eventCount, sizeof(eventCount), 1, file) != 1) {
+        printf("Warning: Input log ended without a trailer\n");
+        reachedEnd = true;
+        return false;
+    }
+
+    if (eventCount == INPUT_LOG_END) {
+        Uint32 recordedFrames = 0;
+        fread(&recordedFrames, sizeof(recordedFrames), 1, file);
+        fread(&expectedHash, sizeof(expectedHash), 1, file);
+        reachedEnd = true;
+        return false;
+    }
+
+    Uint16 events[MAX_FRAME_INPUT_EVENTS];
+    if (fread(dt, sizeof(*dt), 1, file) != 1 ||
+        fread(events, sizeof(Uint16), eventCount, file) != eventCount) {
+        printf("Warning: Input log is truncated\n");
+        reachedEnd = true;
+        return false;
+    }
+
+    // Same order the event pump saw them in
+    for (int i = 0; i < eventCount; i++) {
+        int code = events[i] & 0x0FFF;
+        switch (events[i] >> 12) {
+            case INPUT_EVENT_KEY_DOWN:   Input::SetKey((SDL_Scancode)code, true); break;
+            case INPUT_EVENT_KEY_UP:     Input::SetKey((SDL_Scancode)code, false); break;
+            case INPUT_EVENT_MOUSE_DOWN: Input::SetMouseButton(code, true); break;
+            case INPUT_EVENT_MOUSE_UP:   Input::SetMouseButton(code, false); break;
+        }
+    }
+
+    frameCount++;
+    return true;
+}
+
+void InputRecorder::Finish(Uint32 stateHash) {
+    if (mode == INPUT_RECORDER_RECORD) {
+        Uint8 end = INPUT_LOG_END;
+        fwrite(&end, sizeof(end), 1, file);
+        fwrite(&frameCount, sizeof(frameCount), 1, file);
+        fwrite(&stateHash, sizeof(stateHash), 1, file);
+        printf("Recorded %u frames, state hash %08x\n", frameCount, stateHash);
+    } else if (mode == INPUT_RECORDER_REPLAY) {
+        if (!reachedEnd) {
+            printf("Replay stopped early after %u frames\n", frameCount);
+        } else if (stateHash == expectedHash) {
+            printf("Replay of %u frames matched the recording (hash %08x)\n", frameCount, stateHash);
+        } else {
+            printf("Replay of %u frames DIVERGED: hash %08x, recorded %08x\n",
+                frameCount, stateHash, expectedHash);
+        }
+    }
+
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    mode = INPUT_RECORDER_OFF;
+}
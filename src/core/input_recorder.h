@@ -0,0 +1,60 @@
+#pragma once
+#include <SDL.h>
+#include <stdio.h>
+
+#define INPUT_LOG_MAGIC "MNRI"
+#define INPUT_LOG_VERSION 2          // 2 added the level seed, 1 still replays
+#define INPUT_LOG_END 0xFF            // Event count byte that marks the trailer
+#define MAX_FRAME_INPUT_EVENTS 254    // Anything past this in one frame is dropped
+
+enum InputRecorderMode {
+    INPUT_RECORDER_OFF,
+    INPUT_RECORDER_RECORD,
+    INPUT_RECORDER_REPLAY
+};
+
+enum InputEventType {
+    INPUT_EVENT_KEY_DOWN,
+    INPUT_EVENT_KEY_UP,
+    INPUT_EVENT_MOUSE_DOWN,
+    INPUT_EVENT_MOUSE_UP
+};
+
+// Captures the input events and frame time of every frame into a binary log,
+// and feeds them back on replay. Applying the same events with the same dt
+// rebuilds Input::keys/keysPressed/keysReleased exactly, so a replay runs the
+// same fixed steps as the recorded session.
+//
+// Log layout (little endian):
+//   header   "MNRI", uint32 version, float timeScale, uint32 levelSeed
+//   frame    uint8 eventCount, float dt, eventCount x uint16 (type << 12 | code)
+//   trailer  uint8 0xFF, uint32 frameCount, uint32 state hash
+struct InputRecorder {
+    static InputRecorderMode mode;
+    static FILE* file;
+    static Uint32 frameCount;
+    static bool reachedEnd;      // Replay hit the trailer
+    static Uint32 expectedHash;  // Hash stored in the trailer
+
+    // Events of the frame being recorded, written out in EndRecordFrame
+    static Uint16 frameEvents[MAX_FRAME_INPUT_EVENTS];
+    static int frameEventCount;
+
+    static bool StartRecording(const char* path, float timeScale, Uint32 levelSeed);
+    // Reads the header, timeScale and levelSeed get the recorded values.
+    // Version 1 logs have no seed and leave levelSeed alone.
+    static bool StartReplay(const char* path, float* timeScale, Uint32* levelSeed);
+
+    static bool IsReplaying() { return mode == INPUT_RECORDER_REPLAY; }
+
+    // Recording: called for each input event, then once the frame's events are in
+    static void RecordEvent(InputEventType type, int code);
+    static void EndRecordFrame(float dt);
+
+    // Replay: applies the next frame's events to Input and returns its dt.
+    // Returns false once the log runs out.
+    static bool ReplayFrame(float* dt);
+
+    // Writes the trailer, or checks it when replaying
+    static void Finish(Uint32 stateHash);
+};
@@ -0,0 +1,234 @@
+#include "job_system.h"
+#include <stdio.h>
+
+SDL_Thread* JobSystem::workers[MAX_WORKER_THREADS];
+int JobSystem::workerCount = 0;
+SDL_atomic_t JobSystem::quit;
+JobDeque JobSystem::deques[MAX_WORKER_THREADS + 1];
+JobDeque JobSystem::backgroundJobs;
+SDL_sem* JobSystem::jobsQueued = nullptr;
+
+// Deque the current thread owns. The main thread never sets it.
+static thread_local int threadIndex = 0;
+
+bool JobDeque::Push(const Job& job) {
+    SDL_AtomicLock(&lock);
+    bool pushed = bottom - top < JOB_QUEUE_SIZE;
+    if (pushed) {
+        jobs[bottom & (JOB_QUEUE_SIZE - 1)] = job;
+        bottom++;
+    }
+    SDL_AtomicUnlock(&lock);
+    return pushed;
+}
+
+bool JobDeque::Pop(Job* job) {
+    SDL_AtomicLock(&lock);
+    bool found = bottom > top;
+    if (found) {
+        bottom--;
+        *job = jobs[bottom & (JOB_QUEUE_SIZE - 1)];
+    }
+    SDL_AtomicUnlock(&lock);
+    return found;
+}
+
+bool JobDeque::Steal(Job* job) {
+    // Not worth spinning for, the owner or another thief is on it
+    if (!SDL_AtomicTryLock(&lock)) return false;
+    bool found = bottom > top;
+    if (found) {
+        *job = jobs[top & (JOB_QUEUE_SIZE - 1)];
+        top++;
+    }
+    SDL_AtomicUnlock(&lock);
+    return found;
+}
+
+bool JobDeque::PopOldest(Job* job) {
+    SDL_AtomicLock(&lock);
+    bool found = bottom > top;
+    if (found) {
+        *job = jobs[top & (JOB_QUEUE_SIZE - 1)];
+        top++;
+    }
+    SDL_AtomicUnlock(&lock);
+    return found;
+}
+
+void JobSystem::Init(int count) {
+    workerCount = 0;
+    SDL_AtomicSet(&quit, 0);
+    for (int i = 0; i <= MAX_WORKER_THREADS; i++) {
+        deques[i].top = 0;
+        deques[i].bottom = 0;
+        deques[i].lock = 0;
+    }
+    backgroundJobs.top = 0;
+    backgroundJobs.bottom = 0;
+    backgroundJobs.lock = 0;
+
+#ifdef JOB_SYSTEM_NO_THREADS
+    printf("JobSystem: no thread support, jobs run inline\n");
+    return;
+#endif
+
+    if (count < 0) {
+        count = SDL_GetCPUCount() - 1;
+    }
+    if (count > MAX_WORKER_THREADS) {
+        count = MAX_WORKER_THREADS;
+    }
+    if (count <= 0) {
+        printf("JobSystem: 0 worker threads, jobs run inline\n");
+        return;
+    }
+
+    jobsQueued = SDL_CreateSemaphore(0);
+    if (!jobsQueued) {
+        printf("JobSystem: failed to create semaphore, jobs run inline! SDL Error: %s\n", SDL_GetError());
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        // The deque index travels as the thread argument
+        workers[i] = SDL_CreateThread(WorkerMain, "JobWorker", (void*)(intptr_t)(i + 1));
+        if (!workers[i]) {
+            printf("JobSystem: failed to start worker %d! SDL Error: %s\n", i, SDL_GetError());
+            break;
+        }
+        workerCount++;
+    }
+    printf("JobSystem: %d worker threads\n", workerCount);
+}
+
+void JobSystem::Destroy() {
+    SDL_AtomicSet(&quit, 1);
+    for (int i = 0; i < workerCount; i++) {
+        SDL_SemPost(jobsQueued);
+    }
+    for (int i = 0; i < workerCount; i++) {
+        SDL_WaitThread(workers[i], nullptr);
+        workers[i] = nullptr;
+    }
+    workerCount = 0;
+
+    if (jobsQueued) SDL_DestroySemaphore(jobsQueued);
+    jobsQueued = nullptr;
+}
+
+void JobSystem::Submit(JobFunc func, void* data, JobCounter* counter) {
+    Job job = { func, data, counter };
+    SDL_AtomicAdd(&counter->pending, 1);
+
+    // No workers, or this thread already has a full deque: nobody would get
+    // to it sooner than we do
+    if (workerCount == 0 || !deques[threadIndex].Push(job)) {
+        Execute(job);
+        return;
+    }
+    SDL_SemPost(jobsQueued);
+}
+
+void JobSystem::SubmitBackground(JobFunc func, void* data, JobCounter* counter) {
+    Job job = { func, data, counter };
+    SDL_AtomicAdd(&counter->pending, 1);
+
+    if (workerCount == 0 || !backgroundJobs.Push(job)) {
+        Execute(job);
+        return;
+    }
+    SDL_SemPost(jobsQueued);
+}
+
+bool JobSystem::FindJob(Job* job) {
+    if (workerCount == 0) return false;
+
+    if (deques[threadIndex].Pop(job)) return true;
+
+    // Steal, starting from the next thread so thieves spread out
+    for (int i = 1; i <= workerCount; i++) {
+        int victim = (threadIndex + i) % (workerCount + 1);
+        if (deques[victim].Steal(job)) return true;
+    }
+    return false;
+}
+
+void JobSystem::Execute(const Job& job) {
+    job.func(job.data);
+    SDL_AtomicAdd(&job.counter->pending, -1);
+}
+
+void JobSystem::Wait(JobCounter* counter) {
+    while (SDL_AtomicGet(&counter->pending) > 0) {
+        Job job;
+        if (FindJob(&job)) {
+            Execute(job);
+        } else {
+            // The rest is running on other threads, give them the core
+            SDL_Delay(0);
+        }
+    }
+}
+
+struct ParallelForChunk {
+    ParallelForFunc func;
+    void* data;
+    uint32_t begin, end;
+};
+
+void JobSystem::RunParallelForChunk(void* data) {
+    ParallelForChunk* chunk = (ParallelForChunk*)data;
+    chunk->func(chunk->data, chunk->begin, chunk->end);
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t chunkSize, ParallelForFunc func, void* data) {
+    if (chunkSize == 0) chunkSize = 1;
+    if (workerCount == 0 || count <= chunkSize) {
+        if (count > 0) func(data, 0, count);
+        return;
+    }
+
+    // Grow the chunks if there would be more than fit on the stack
+    uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount > PARALLEL_FOR_MAX_JOBS) {
+        chunkCount = PARALLEL_FOR_MAX_JOBS;
+        chunkSize = (count + chunkCount - 1) / chunkCount;
+        chunkCount = (count + chunkSize - 1) / chunkSize;
+    }
+
+    ParallelForChunk chunks[PARALLEL_FOR_MAX_JOBS];
+    JobCounter counter;
+    SDL_AtomicSet(&counter.pending, 0);
+
+    // The first chunk is kept for this thread, the rest go on its deque for
+    // the others to steal
+    for (uint32_t i = 1; i < chunkCount; i++) {
+        chunks[i].func = func;
+        chunks[i].data = data;
+        chunks[i].begin = i * chunkSize;
+        chunks[i].end = i * chunkSize + chunkSize < count ? i * chunkSize + chunkSize : count;
+        Submit(RunParallelForChunk, &chunks[i], &counter);
+    }
+    func(data, 0, chunkSize);
+
+    Wait(&counter);
+}
+
+int JobSystem::WorkerMain(void* data) {
+    threadIndex = (int)(intptr_t)data;
+
+    for (;;) {
+        SDL_SemWait(jobsQueued);
+        if (SDL_AtomicGet(&quit)) break;
+
+        // Drain what can be found, background jobs once nothing else is
+        // left. Tokens can outnumber the jobs left, the extra wakeups just
+        // find nothing.
+        Job job;
+        while (FindJob(&job) || backgroundJobs.PopOldest(&job)) {
+            Execute(job);
+        }
+    }
+    return 0;
+}
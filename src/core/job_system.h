@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL.h>
+
+// The web build is compiled without -pthread, everything runs inline there
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define JOB_SYSTEM_NO_THREADS
+#endif
+
+#define MAX_WORKER_THREADS 16
+#define JOB_QUEUE_SIZE 256      // Jobs one thread can have queued, a power of two
+#define PARALLEL_FOR_MAX_JOBS 64  // Chunks one ParallelFor splits into at most
+
+typedef void (*JobFunc)(void* data);
+typedef void (*ParallelForFunc)(void* data, uint32_t begin, uint32_t end);
+
+// Unfinished jobs of one batch. Start it at zero, Submit counts up and each
+// finished job counts down, Wait until it is back to zero.
+struct JobCounter {
+    SDL_atomic_t pending;
+};
+
+struct Job {
+    JobFunc func;
+    void* data;
+    JobCounter* counter;
+};
+
+// Per-thread job deque. The owner pushes and pops at the bottom (newest
+// first, its data is still in cache), idle threads steal from the top.
+struct JobDeque {
+    Job jobs[JOB_QUEUE_SIZE];
+    int top;        // Oldest job, next to be stolen
+    int bottom;     // One past the newest job
+    SDL_SpinLock lock;
+
+    bool Push(const Job& job);
+    bool Pop(Job* job);
+    bool Steal(Job* job);
+    bool PopOldest(Job* job);  // Steal that waits for the lock
+};
+
+// A few worker threads running small jobs, with work stealing. Each thread
+// (the main thread is index 0) queues the jobs it submits on its own deque,
+// and a thread that runs out of work takes the oldest job of another one.
+// A thread waiting on a counter keeps running jobs instead of sleeping, so
+// with zero workers every job just runs on the caller.
+struct JobSystem {
+    // workerCount -1 starts one per core minus the main thread
+    static void Init(int workerCount);
+    static void Destroy();
+    static int WorkerCount() { return workerCount; }
+
+    // Jobs can submit more jobs, against the same counter or another one
+    static void Submit(JobFunc func, void* data, JobCounter* counter);
+    static void Wait(JobCounter* counter);
+
+    // For long jobs nobody waits on soon, like decoding a sound. Only idle
+    // workers run them, Wait never does, so they can't stall a ParallelFor
+    // or the frame. Runs inline when there are no workers.
+    static void SubmitBackground(JobFunc func, void* data, JobCounter* counter);
+
+    // Calls func(data, begin, end) over [0, count) in chunks of at least
+    // chunkSize and returns when all are done. Chunks run in any order and
+    // on any thread, so func must only write to its own range. Small ranges
+    // run inline.
+    static void ParallelFor(uint32_t count, uint32_t chunkSize, ParallelForFunc func, void* data);
+
+    // Same with a lambda: ParallelFor(count, 64, [&](uint32_t begin, uint32_t end) { ... });
+    template <typename Fn>
+    static void ParallelFor(uint32_t count, uint32_t chunkSize, const Fn& fn) {
+        ParallelFor(count, chunkSize, CallRange<Fn>, (void*)&fn);
+    }
+
+private:
+    static SDL_Thread* workers[MAX_WORKER_THREADS];
+    static int workerCount;
+    static SDL_atomic_t quit;
+
+    // Index 0 is the main thread, worker i uses deque i + 1
+    static JobDeque deques[MAX_WORKER_THREADS + 1];
+    static JobDeque backgroundJobs;  // Shared by all workers, oldest first
+    static SDL_sem* jobsQueued;  // Posted once per queued job
+
+    template <typename Fn>
+    static void CallRange(void* data, uint32_t begin, uint32_t end) {
+        (*(const Fn*)data)(begin, end);
+    }
+
+    static bool FindJob(Job* job);
+    static void Execute(const Job& job);
+    static void RunParallelForChunk(void* data);
+    static int WorkerMain(void* data);
+};
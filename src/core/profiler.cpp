@@ -0,0 +1,134 @@
+#include "profiler.h"
+#include "resource_manager.h"
+#include "engine.h"
+#include "window.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+ProfileZone Profiler::zones[PROFILER_MAX_ZONES];
+int Profiler::zoneCount = 0;
+int Profiler::historyCount = 0;
+int Profiler::historyNext = 0;
+bool Profiler::showOverlay = false;
+
+static Uint64 s_FrameStart = 0;
+static int s_FrameZone = -1;
+
+int Profiler::RegisterZone(const char* name) {
+    for (int i = 0; i < zoneCount; i++) {
+        if (strcmp(zones[i].name, name) == 0) return i;
+    }
+
+    if (zoneCount >= PROFILER_MAX_ZONES) {
+        printf("Warning: Maximum number of profiler zones reached!\n");
+        return PROFILER_MAX_ZONES - 1;
+    }
+
+    ProfileZone* zone = &zones[zoneCount];
+    zone->name = name;
+    zone->frameTicks = 0;
+    memset(zone->history, 0, sizeof(zone->history));
+    return zoneCount++;
+}
+
+void Profiler::AddTime(int zone, Uint64 ticks) {
+    zones[zone].frameTicks += ticks;
+}
+
+void Profiler::BeginFrame() {
+    if (s_FrameZone < 0) {
+        s_FrameZone = RegisterZone("Frame");
+    }
+    s_FrameStart = SDL_GetPerformanceCounter();
+}
+
+void Profiler::EndFrame() {
+    AddTime(s_FrameZone, SDL_GetPerformanceCounter() - s_FrameStart);
+
+    // Push this frame's totals into every zone's history
+    float msPerTick = 1000.0f / (float)SDL_GetPerformanceFrequency();
+    for (int i = 0; i < zoneCount; i++) {
+        zones[i].history[historyNext] = zones[i].frameTicks * msPerTick;
+        zones[i].frameTicks = 0;
+    }
+
+    historyNext = (historyNext + 1) % PROFILER_HISTORY;
+    if (historyCount < PROFILER_HISTORY) historyCount++;
+}
+
+static int CompareFloat(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+ProfileStats Profiler::GetStats(int zone) {
+    ProfileStats stats = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (zone < 0 || zone >= zoneCount || historyCount == 0) return stats;
+
+    float sorted[PROFILER_HISTORY];
+    memcpy(sorted, zones[zone].history, historyCount * sizeof(float));
+    qsort(sorted, historyCount, sizeof(float), CompareFloat);
+
+    float sum = 0.0f;
+    for (int i = 0; i < historyCount; i++) {
+        sum += sorted[i];
+    }
+
+    stats.min = sorted[0];
+    stats.avg = sum / historyCount;
+    stats.p99 = sorted[(historyCount - 1) * 99 / 100];
+    stats.max = sorted[historyCount - 1];
+    return stats;
+}
+
+void Profiler::DrawOverlay(int x, int y) {
+    if (!showOverlay) return;
+
+    Font* font = ResourceManager::GetFont(FONT_FPS);
+    if (!font) return;
+
+    const int LINE_HEIGHT = font->lineHeight + 2;
+    SDL_Renderer* renderer = g_Engine.window->renderer;
+
+    // Dim the area behind the table so it reads over clouds
+    SDL_Rect background = {x - 5, y - 5, 470, LINE_HEIGHT * (zoneCount + 1) + 10};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &background);
+
+    SDL_Color headerColor = {255, 255, 0, 255};
+    SDL_Color textColor = {255, 255, 255, 255};
+    char line[96];
+
+    snprintf(line, sizeof(line), "%-20s %6s %6s %6s", "ms", "min", "avg", "p99");
+    ResourceManager::RenderText(font, line, headerColor, x, y);
+
+    for (int i = 0; i < zoneCount; i++) {
+        ProfileStats stats = GetStats(i);
+        snprintf(line, sizeof(line), "%-20.20s %6.2f %6.2f %6.2f", zones[i].name, stats.min, stats.avg, stats.p99);
+        ResourceManager::RenderText(font, line, textColor, x, y + LINE_HEIGHT * (i + 1));
+    }
+}
+
+bool Profiler::WriteCSV(const char* path) {
+    if (zoneCount == 0 || historyCount == 0) return false;
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Failed to write profile to %s\n", path);
+        return false;
+    }
+
+    fprintf(file, "zone,min_ms,avg_ms,p99_ms,max_ms,frames\n");
+    for (int i = 0; i < zoneCount; i++) {
+        ProfileStats stats = GetStats(i);
+        fprintf(file, "%s,%.4f,%.4f,%.4f,%.4f,%d\n",
+            zones[i].name, stats.min, stats.avg, stats.p99, stats.max, historyCount);
+    }
+
+    fclose(file);
+    printf("Profile written to %s\n", path);
+    return true;
+}
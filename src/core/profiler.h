@@ -0,0 +1,55 @@
+#pragma once
+#include <SDL.h>
+
+#define PROFILER_MAX_ZONES 32
+#define PROFILER_HISTORY 240       // Frames kept for the rolling stats (4s at 60fps)
+
+// Per-frame timing for named zones. Time spent in a zone is summed over the
+// frame (fixed-step systems can run several times or not at all), and the
+// last PROFILER_HISTORY frame totals give the min/avg/p99 stats.
+struct ProfileStats {
+    float min, avg, p99, max;  // Milliseconds
+};
+
+struct ProfileZone {
+    const char* name;
+    Uint64 frameTicks;                // Accumulated this frame
+    float history[PROFILER_HISTORY];  // Milliseconds per frame, ring buffer
+};
+
+struct Profiler {
+    static ProfileZone zones[PROFILER_MAX_ZONES];
+    static int zoneCount;
+    static int historyCount;   // Valid entries in every zone's history
+    static int historyNext;    // Ring buffer write position
+    static bool showOverlay;   // Toggled with F3
+
+    // Returns the zone's id, registering it on first use of the name
+    static int RegisterZone(const char* name);
+    static void AddTime(int zone, Uint64 ticks);
+
+    // Frame boundaries, the whole frame is tracked as the "Frame" zone
+    static void BeginFrame();
+    static void EndFrame();
+
+    static ProfileStats GetStats(int zone);
+    static void DrawOverlay(int x, int y);
+    static bool WriteCSV(const char* path);
+};
+
+// Adds the time until the end of the enclosing block to a zone
+struct ProfileScope {
+    int zone;
+    Uint64 start;
+
+    ProfileScope(int zoneId) : zone(zoneId), start(SDL_GetPerformanceCounter()) {}
+    ~ProfileScope() { Profiler::AddTime(zone, SDL_GetPerformanceCounter() - start); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// PROFILE_SCOPE("Name") times the rest of the current block
+#define PROFILE_SCOPE(name) \
+    static int PROFILE_CONCAT(profileZone_, __LINE__) = Profiler::RegisterZone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileZone_, __LINE__))
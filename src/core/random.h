@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+
+// PCG32 (pcg-random.org): a 64-bit LCG with a permuted 32-bit output. Each
+// instance is its own generator, so level chunks can be rolled on different
+// threads in any order and still come out the same for a given seed.
+struct Random {
+    uint64_t state;
+    uint64_t increment;  // Always odd, selects one of 2^63 independent streams
+
+    void Init(uint64_t seed, uint64_t stream = 0) {
+        state = 0;
+        increment = (stream << 1) | 1u;
+        Next();
+        state += seed;
+        Next();
+    }
+
+    uint32_t Next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, bound), without the bias of Next() % bound
+    uint32_t Range(uint32_t bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        for (;;) {
+            uint32_t r = Next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+
+    // Uniform in [0, 1)
+    float Float() {
+        return (float)(Next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+// SplitMix64 finalizer. Turns related inputs (a level seed plus a chunk
+// index) into unrelated seeds.
+inline uint64_t SplitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
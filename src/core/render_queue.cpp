@@ -0,0 +1,134 @@
+#include "render_queue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+static int CompareRenderCommands(const void* a, const void* b) {
+    const RenderCommand* commandA = (const RenderCommand*)a;
+    const RenderCommand* commandB = (const RenderCommand*)b;
+
+    if (commandA->layer != commandB->layer) {
+        return commandA->layer < commandB->layer ? -1 : 1;
+    }
+    // Textures packed into the same atlas page share an SDL_Texture
+    if (commandA->texture->sdlTexture != commandB->texture->sdlTexture) {
+        return (uintptr_t)commandA->texture->sdlTexture < (uintptr_t)commandB->texture->sdlTexture ? -1 : 1;
+    }
+    return (int)commandA->sequence - (int)commandB->sequence;
+}
+
+void RenderQueue::Init() {
+    // Every quad is two triangles over its own 4 vertices
+    for (int i = 0; i < MAX_RENDER_COMMANDS; i++) {
+        int base = i * 4;
+        indices[i * 6 + 0] = base + 0;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base + 2;
+        indices[i * 6 + 4] = base + 3;
+        indices[i * 6 + 5] = base + 0;
+    }
+
+    for (int i = 0; i < MAX_RENDER_COMMANDS * 4; i++) {
+        vertices[i].color = {255, 255, 255, 255};
+    }
+
+    commandCount = 0;
+    batchCount = 0;
+    spriteCount = 0;
+}
+
+void RenderQueue::Destroy() {
+    commandCount = 0;
+}
+
+void RenderQueue::Begin() {
+    commandCount = 0;
+}
+
+void RenderQueue::Submit(RenderLayer layer, Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& destRect, float rotation) {
+    if (!texture || !texture->sdlTexture) return;
+
+    if (commandCount >= MAX_RENDER_COMMANDS) {
+        printf("Warning: Render queue full, dropping sprite\n");
+        return;
+    }
+
+    RenderCommand* command = &commands[commandCount];
+    command->layer = (uint8_t)layer;
+    command->sequence = (uint16_t)commandCount;
+    command->texture = texture;
+    command->srcRect = srcRect;
+    command->destRect = destRect;
+    command->rotation = rotation;
+    commandCount++;
+}
+
+void RenderQueue::WriteQuad(SDL_Vertex* quad, const RenderCommand& command) {
+    float invWidth = 1.0f / command.texture->pageWidth;
+    float invHeight = 1.0f / command.texture->pageHeight;
+    float u0 = command.srcRect.x * invWidth;
+    float v0 = command.srcRect.y * invHeight;
+    float u1 = (command.srcRect.x + command.srcRect.w) * invWidth;
+    float v1 = (command.srcRect.y + command.srcRect.h) * invHeight;
+
+    // Corners relative to the center, clockwise from the top left
+    float halfWidth = command.destRect.w * 0.5f;
+    float halfHeight = command.destRect.h * 0.5f;
+    float centerX = command.destRect.x + halfWidth;
+    float centerY = command.destRect.y + halfHeight;
+    float cornerX[4] = {-halfWidth, halfWidth, halfWidth, -halfWidth};
+    float cornerY[4] = {-halfHeight, -halfHeight, halfHeight, halfHeight};
+
+    if (command.rotation != 0.0f) {
+        // Same convention as SDL_RenderCopyEx: clockwise on screen
+        float radians = command.rotation * (float)M_PI / 180.0f;
+        float c = cosf(radians);
+        float s = sinf(radians);
+        for (int i = 0; i < 4; i++) {
+            float x = cornerX[i];
+            float y = cornerY[i];
+            cornerX[i] = x * c - y * s;
+            cornerY[i] = x * s + y * c;
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        quad[i].position.x = centerX + cornerX[i];
+        quad[i].position.y = centerY + cornerY[i];
+    }
+    quad[0].tex_coord = {u0, v0};
+    quad[1].tex_coord = {u1, v0};
+    quad[2].tex_coord = {u1, v1};
+    quad[3].tex_coord = {u0, v1};
+}
+
+void RenderQueue::Flush(SDL_Renderer* renderer) {
+    batchCount = 0;
+    spriteCount = commandCount;
+    if (commandCount == 0) return;
+
+    qsort(commands, commandCount, sizeof(RenderCommand), CompareRenderCommands);
+
+    int runStart = 0;
+    while (runStart < commandCount) {
+        SDL_Texture* sdlTexture = commands[runStart].texture->sdlTexture;
+        int runEnd = runStart;
+        while (runEnd < commandCount &&
+               commands[runEnd].layer == commands[runStart].layer &&
+               commands[runEnd].texture->sdlTexture == sdlTexture) {
+            WriteQuad(&vertices[runEnd * 4], commands[runEnd]);
+            runEnd++;
+        }
+
+        int quadCount = runEnd - runStart;
+        SDL_RenderGeometry(renderer, sdlTexture,
+            &vertices[runStart * 4], quadCount * 4,
+            indices, quadCount * 6);
+        batchCount++;
+
+        runStart = runEnd;
+    }
+
+    commandCount = 0;
+}
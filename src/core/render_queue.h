@@ -0,0 +1,48 @@
+#pragma once
+#include <SDL.h>
+#include "resource_manager.h"
+
+#define MAX_RENDER_COMMANDS 2048
+
+// Draw order buckets, lower layers are drawn first
+enum RenderLayer {
+    RENDER_LAYER_BACKGROUND = 0,
+    RENDER_LAYER_WORLD,
+    RENDER_LAYER_FOREGROUND,
+    RENDER_LAYER_COUNT
+};
+
+struct RenderCommand {
+    uint8_t layer;
+    uint16_t sequence;  // Submission order, keeps the sort stable
+    Texture* texture;
+    SDL_Rect srcRect;   // In atlas page pixels
+    SDL_Rect destRect;
+    float rotation;     // Degrees clockwise around the center of destRect
+};
+
+// Collects sprite draws for a frame, sorts them by layer then texture and
+// submits every run of same-texture sprites with a single SDL_RenderGeometry.
+// Sprites from the same atlas page count as the same texture.
+struct RenderQueue {
+    RenderCommand commands[MAX_RENDER_COMMANDS];
+    int commandCount;
+
+    // Vertices are rewritten every flush, indices never change
+    SDL_Vertex vertices[MAX_RENDER_COMMANDS * 4];
+    int indices[MAX_RENDER_COMMANDS * 6];
+
+    // Stats for the last flush
+    int batchCount;
+    int spriteCount;
+
+    void Init();
+    void Destroy();
+
+    void Begin();
+    void Submit(RenderLayer layer, Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& destRect, float rotation);
+    void Flush(SDL_Renderer* renderer);
+
+private:
+    void WriteQuad(SDL_Vertex* quad, const RenderCommand& command);
+};
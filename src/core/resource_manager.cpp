@@ -1,17 +1,74 @@
 #include "resource_manager.h"
 #include "engine.h"
 #include "window.h"
+#include "job_system.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string.h>
 
 // Initialize static arrays
 Texture* ResourceManager::textures[TEXTURE_MAX] = {nullptr};
 Sound* ResourceManager::sounds[SOUND_MAX] = {nullptr};
 Font* ResourceManager::fonts[FONT_MAX] = {nullptr};
+SDL_Texture* ResourceManager::atlasPages[ATLAS_MAX_PAGES] = {nullptr};
+int ResourceManager::atlasPageCount = 0;
+
+// A sound still decoding on the job threads. path is set while the load is
+// in flight, the job only writes chunk.
+struct SoundLoad {
+    const char* path;
+    Mix_Chunk* chunk;
+    JobCounter counter;
+};
+static SoundLoad s_SoundLoads[SOUND_MAX];
 
 void ResourceManager::Cleanup() {
+#ifndef HEADLESS
     Mix_CloseAudio();
+#endif
 }
 
+#ifdef HEADLESS
+// Reads the size from the PNG header (signature, then the IHDR chunk with
+// big-endian width and height) without decoding anything
+static bool ReadPNGSize(const char* path, int* width, int* height) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    unsigned char header[24];
+    size_t read = fread(header, 1, sizeof(header), file);
+    fclose(file);
+
+    static const unsigned char PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (read != sizeof(header) || memcmp(header, PNG_SIGNATURE, 8) != 0 || memcmp(header + 12, "IHDR", 4) != 0) {
+        return false;
+    }
+
+    *width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+    *height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+    return true;
+}
+
+// Headless textures only know their size, there is nothing to draw with
+Texture* ResourceManager::LoadTexture(const char* path) {
+    int width, height;
+    if (!ReadPNGSize(path, &width, &height)) {
+        printf("Failed to read PNG header of %s!\n", path);
+        return nullptr;
+    }
+
+    Texture* texture = new Texture();
+    texture->sdlTexture = nullptr;
+    texture->width = width;
+    texture->height = height;
+    texture->atlasRect = {0, 0, width, height};
+    texture->atlasPage = -1;
+    texture->pageWidth = width;
+    texture->pageHeight = height;
+    return texture;
+}
+#else
 Texture* ResourceManager::LoadTexture(const char* path) {
     SDL_Surface* surface = IMG_Load(path);
     if (!surface) {
@@ -19,19 +76,29 @@ Texture* ResourceManager::LoadTexture(const char* path) {
         return nullptr;
     }
     
-    SDL_Texture* sdlTexture = SDL_CreateTextureFromSurface(g_Engine.window->renderer, surface);
-    if (!sdlTexture) {
+    Texture* texture = CreateTexture(surface);
+    if (!texture) {
         printf("Failed to create texture from %s! SDL Error: %s\n", path, SDL_GetError());
-        SDL_FreeSurface(surface);
-        return nullptr;
     }
     
+    SDL_FreeSurface(surface);
+    return texture;
+}
+#endif
+
+// Creates a standalone texture that owns its SDL_Texture
+Texture* ResourceManager::CreateTexture(SDL_Surface* surface) {
+    SDL_Texture* sdlTexture = SDL_CreateTextureFromSurface(g_Engine.window->renderer, surface);
+    if (!sdlTexture) return nullptr;
+
     Texture* texture = new Texture();
     texture->sdlTexture = sdlTexture;
     texture->width = surface->w;
     texture->height = surface->h;
-    
-    SDL_FreeSurface(surface);
+    texture->atlasRect = {0, 0, surface->w, surface->h};
+    texture->atlasPage = -1;
+    texture->pageWidth = surface->w;
+    texture->pageHeight = surface->h;
     return texture;
 }
 
@@ -66,7 +133,8 @@ Texture* ResourceManager::GetTexture(TextureID id) {
 
 void ResourceManager::UnloadTexture(Texture* texture) {
     if (texture) {
-        if (texture->sdlTexture) {
+        // Atlas pages are shared and destroyed in UnloadAllResources
+        if (texture->sdlTexture && texture->atlasPage < 0) {
             SDL_DestroyTexture(texture->sdlTexture);
         }
         delete texture;
@@ -81,6 +149,7 @@ void ResourceManager::UnloadTexture(TextureID id) {
     }
 }
 
+#ifndef HEADLESS
 Font* ResourceManager::LoadFont(const char* path, int size) {
     TTF_Font* sdlFont = TTF_OpenFont(path, size);
     if (!sdlFont) {
@@ -91,11 +160,68 @@ Font* ResourceManager::LoadFont(const char* path, int size) {
     Font* font = new Font();
     font->sdlFont = sdlFont;
     font->size = size;
+    font->glyphAtlas = nullptr;
+    font->lineHeight = TTF_FontHeight(sdlFont);
+
+    if (!BuildGlyphAtlas(font)) {
+        printf("Failed to build glyph atlas for %s, falling back to per-string textures\n", path);
+    }
     return font;
 }
 
+// Renders every printable ASCII glyph once and packs them into a single texture
+bool ResourceManager::BuildGlyphAtlas(Font* font) {
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, FONT_ATLAS_SIZE, FONT_ATLAS_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlasSurface) return false;
+    SDL_FillRect(atlasSurface, NULL, 0);
+
+    SkylinePacker packer;
+    packer.Init(FONT_ATLAS_SIZE, FONT_ATLAS_SIZE);
+    SDL_Color white = {255, 255, 255, 255};
+
+    for (int i = 0; i < FONT_GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16)(FONT_FIRST_GLYPH + i);
+        Glyph* glyph = &font->glyphs[i];
+        glyph->rect = {0, 0, 0, 0};
+        glyph->advance = 0;
+
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics(font->sdlFont, ch, &minX, &maxX, &minY, &maxY, &advance) == 0) {
+            glyph->advance = advance;
+        }
+
+        // Surfaces come out one line tall, so glyphs line up without any offsets
+        SDL_Surface* glyphSurface = TTF_RenderGlyph_Blended(font->sdlFont, ch, white);
+        if (!glyphSurface) continue;
+
+        SDL_Rect rect;
+        if (!packer.Pack(glyphSurface->w + ATLAS_PADDING * 2, glyphSurface->h + ATLAS_PADDING * 2, &rect)) {
+            printf("Glyph atlas is full at character '%c'\n", (char)ch);
+            SDL_FreeSurface(glyphSurface);
+            SDL_FreeSurface(atlasSurface);
+            return false;
+        }
+        glyph->rect = {rect.x + ATLAS_PADDING, rect.y + ATLAS_PADDING, glyphSurface->w, glyphSurface->h};
+
+        SDL_SetSurfaceBlendMode(glyphSurface, SDL_BLENDMODE_NONE);
+        SDL_Rect dest = glyph->rect;
+        SDL_BlitSurface(glyphSurface, NULL, atlasSurface, &dest);
+        SDL_FreeSurface(glyphSurface);
+    }
+
+    font->glyphAtlas = SDL_CreateTextureFromSurface(g_Engine.window->renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+    if (!font->glyphAtlas) return false;
+
+    SDL_SetTextureBlendMode(font->glyphAtlas, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
 void ResourceManager::UnloadFont(Font* font) {
     if (font) {
+        if (font->glyphAtlas) {
+            SDL_DestroyTexture(font->glyphAtlas);
+        }
         if (font->sdlFont) {
             TTF_CloseFont(font->sdlFont);
         }
@@ -124,6 +250,15 @@ void ResourceManager::UnloadSound(Sound* sound) {
     }
 }
 
+#else
+// Nothing is drawn headless, so fonts and sounds are never loaded
+Font* ResourceManager::LoadFont(const char* path, int size) { return nullptr; }
+bool ResourceManager::BuildGlyphAtlas(Font* font) { return false; }
+void ResourceManager::UnloadFont(Font* font) { delete font; }
+Sound* ResourceManager::LoadSound(const char* path) { return nullptr; }
+void ResourceManager::UnloadSound(Sound* sound) { delete sound; }
+#endif
+
 void ResourceManager::RenderTexture(Texture* texture, int x, int y) {
     if (!texture || !texture->sdlTexture) return;
     
@@ -133,36 +268,103 @@ void ResourceManager::RenderTexture(Texture* texture, int x, int y) {
     destRect.w = texture->width;
     destRect.h = texture->height;
     
-    SDL_RenderCopy(g_Engine.window->renderer, texture->sdlTexture, NULL, &destRect);
+    SDL_RenderCopy(g_Engine.window->renderer, texture->sdlTexture, &texture->atlasRect, &destRect);
 }
 
 Texture* ResourceManager::GetTextTexture(Font* font, const char* text, SDL_Color color){
     if (!font || !font->sdlFont) return nullptr;
-    
+
+#ifdef HEADLESS
+    return nullptr;
+#else    
     SDL_Surface* surface = TTF_RenderText_Solid(font->sdlFont, text, color);
     if (!surface) {
         printf("Failed to render text surface! SDL_ttf Error: %s\n", TTF_GetError());
         return nullptr;
     }
     
-    SDL_Texture* sdlTexture = SDL_CreateTextureFromSurface(g_Engine.window->renderer, surface);
-    if (!sdlTexture) {
+    Texture* texture = CreateTexture(surface);
+    if (!texture) {
         printf("Failed to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
-        SDL_FreeSurface(surface);
-        return nullptr;
     }
     
-    Texture* texture = new Texture();
-    texture->sdlTexture = sdlTexture;
-    texture->width = surface->w;
-    texture->height = surface->h;
-    
     SDL_FreeSurface(surface);
 
     return texture;
+#endif
+}
+
+static const Glyph* FindGlyph(Font* font, char c) {
+    if (c < FONT_FIRST_GLYPH || c > FONT_LAST_GLYPH) c = '?';
+    return &font->glyphs[c - FONT_FIRST_GLYPH];
+}
+
+int ResourceManager::MeasureText(Font* font, const char* text) {
+    int width = 0;
+    for (const char* c = text; *c; c++) {
+        width += FindGlyph(font, *c)->advance;
+    }
+    return width;
+}
+
+// Text is built into these every call, no allocations or uploads per frame
+static SDL_Vertex s_TextVertices[MAX_TEXT_GLYPHS * 4];
+static int s_TextIndices[MAX_TEXT_GLYPHS * 6];
+static bool s_TextIndicesBuilt = false;
+
+void ResourceManager::RenderText(Font* font, const char* text, SDL_Color color, int x, int y) {
+    if (!font || !font->glyphAtlas) return;
+
+    if (!s_TextIndicesBuilt) {
+        for (int i = 0; i < MAX_TEXT_GLYPHS; i++) {
+            s_TextIndices[i * 6 + 0] = i * 4 + 0;
+            s_TextIndices[i * 6 + 1] = i * 4 + 1;
+            s_TextIndices[i * 6 + 2] = i * 4 + 2;
+            s_TextIndices[i * 6 + 3] = i * 4 + 2;
+            s_TextIndices[i * 6 + 4] = i * 4 + 3;
+            s_TextIndices[i * 6 + 5] = i * 4 + 0;
+        }
+        s_TextIndicesBuilt = true;
+    }
+
+    const float invSize = 1.0f / FONT_ATLAS_SIZE;
+    int quadCount = 0;
+    float penX = (float)x;
+
+    for (const char* c = text; *c && quadCount < MAX_TEXT_GLYPHS; c++) {
+        const Glyph* glyph = FindGlyph(font, *c);
+        if (glyph->rect.w > 0) {
+            float left = penX;
+            float top = (float)y;
+            float right = left + glyph->rect.w;
+            float bottom = top + glyph->rect.h;
+            float u0 = glyph->rect.x * invSize;
+            float v0 = glyph->rect.y * invSize;
+            float u1 = (glyph->rect.x + glyph->rect.w) * invSize;
+            float v1 = (glyph->rect.y + glyph->rect.h) * invSize;
+
+            SDL_Vertex* quad = &s_TextVertices[quadCount * 4];
+            quad[0] = {{left, top}, color, {u0, v0}};
+            quad[1] = {{right, top}, color, {u1, v0}};
+            quad[2] = {{right, bottom}, color, {u1, v1}};
+            quad[3] = {{left, bottom}, color, {u0, v1}};
+            quadCount++;
+        }
+        penX += glyph->advance;
+    }
+
+    if (quadCount > 0) {
+        SDL_RenderGeometry(g_Engine.window->renderer, font->glyphAtlas,
+            s_TextVertices, quadCount * 4, s_TextIndices, quadCount * 6);
+    }
 }
 
 int ResourceManager::RenderTextAlignedTopRight(Font* font, const char* text, SDL_Color color, int x, int y) {
+    if (font && font->glyphAtlas) {
+        RenderText(font, text, color, x - MeasureText(font, text), y);
+        return true;
+    }
+
     Texture* texture = ResourceManager::GetTextTexture(font, text, color);
 
     if (texture) {
@@ -176,6 +378,11 @@ int ResourceManager::RenderTextAlignedTopRight(Font* font, const char* text, SDL
 
 
 void ResourceManager::RenderTextAlignedCenter(Font* font, const char* text, SDL_Color color, int x, int y) {
+    if (font && font->glyphAtlas) {
+        RenderText(font, text, color, x - MeasureText(font, text)/2, y - font->lineHeight/2);
+        return;
+    }
+
     Texture* texture = ResourceManager::GetTextTexture(font, text, color);
 
     if (texture) {
@@ -194,10 +401,8 @@ Sound* ResourceManager::LoadSound(const char* path, SoundID id) {
         return nullptr;
     }
     
-    // Unload existing sound if any
-    if (sounds[id]) {
-        UnloadSound(id);
-    }
+    // Unload existing sound if any, waiting out a decode still in flight
+    UnloadSound(id);
     
     sounds[id] = LoadSound(path);  // Use existing load function
     return sounds[id];
@@ -208,11 +413,35 @@ Sound* ResourceManager::GetSound(SoundID id) {
         printf("Invalid sound ID: %d\n", id);
         return nullptr;
     }
+    // Still nullptr while its decode job runs
+    if (!sounds[id] && s_SoundLoads[id].path && SDL_AtomicGet(&s_SoundLoads[id].counter.pending) == 0) {
+        FinishSoundLoad(id);
+    }
     return sounds[id];
 }
 
+// Publishes a finished decode job into sounds[]. That isn't locked: the
+// systems calling PlaySound run on job threads, but they all declare
+// SYSTEM_RESOURCE_AUDIO as a write, so the scheduler never runs two of them
+// at once. Any other GetSound/PlaySound caller has to do the same or stay
+// on the main thread outside the system update.
+void ResourceManager::FinishSoundLoad(SoundID id) {
+    SoundLoad* load = &s_SoundLoads[id];
+    if (!load->path) return;
+
+    JobSystem::Wait(&load->counter);
+    if (load->chunk) {
+        Sound* sound = new Sound();
+        sound->sdlChunk = load->chunk;
+        sounds[id] = sound;
+    }
+    load->path = nullptr;
+    load->chunk = nullptr;
+}
+
 void ResourceManager::UnloadSound(SoundID id) {
     if (id <= SOUND_NONE || id >= SOUND_MAX) return;
+    FinishSoundLoad(id);
     if (sounds[id]) {
         UnloadSound(sounds[id]);  // Use existing unload function
         sounds[id] = nullptr;
@@ -250,15 +479,49 @@ void ResourceManager::UnloadFont(FontID id) {
     }
 }
 
+// Sounds are queued first as background jobs and left decoding. Idle
+// workers only take those once the texture decodes are gone, and the main
+// thread never does, so waiting for the textures can't get stuck behind the
+// music. GetSound returns nullptr until a sound is done.
 bool ResourceManager::InitAllResources() {
-    if (!InitTextures()) return false;
     if (!InitSounds()) return false;
+    if (!InitTextures()) return false;
     if (!InitFonts()) return false;
     return true;
 }
 
+#ifndef HEADLESS
+struct TextureDecode {
+    const char* path;
+    SDL_Surface* surface;   // RGBA32, nullptr if it failed
+};
+
+// Runs on any job thread, only touches the CPU side
+static void DecodeTexture(void* data) {
+    TextureDecode* decode = (TextureDecode*)data;
+    SDL_Surface* loaded = IMG_Load(decode->path);
+    decode->surface = loaded ? SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+    if (loaded) SDL_FreeSurface(loaded);
+
+    if (!decode->surface) {
+        printf("Failed to load texture: %s! SDL_image Error: %s\n", decode->path, IMG_GetError());
+    }
+}
+
+static void DecodeSound(void* data) {
+    SoundLoad* load = (SoundLoad*)data;
+    load->chunk = Mix_LoadWAV(load->path);
+    if (!load->chunk) {
+        printf("Failed to load sound %s! SDL_mixer Error: %s\n", load->path, Mix_GetError());
+    }
+}
+#endif
+
 bool ResourceManager::InitTextures() {
     const int textureCount = sizeof(GAME_TEXTURES) / sizeof(GAME_TEXTURES[0]);
+
+#ifdef HEADLESS
+    // Sizes only, no atlas
     for (int i = 0; i < textureCount; i++) {
         if (!LoadTexture(GAME_TEXTURES[i].path, GAME_TEXTURES[i].id)) {
             printf("Failed to load texture: %s\n", GAME_TEXTURES[i].path);
@@ -266,20 +529,172 @@ bool ResourceManager::InitTextures() {
         }
     }
     return true;
+#else
+    // One decode job per image, the atlas needs all of them before packing
+    TextureDecode decodes[textureCount];
+    JobCounter counter = {};
+    for (int i = 0; i < textureCount; i++) {
+        decodes[i].path = GAME_TEXTURES[i].path;
+        decodes[i].surface = nullptr;
+        JobSystem::Submit(DecodeTexture, &decodes[i], &counter);
+    }
+    JobSystem::Wait(&counter);
+
+    SDL_Surface* surfaces[textureCount];
+    bool success = true;
+    for (int i = 0; i < textureCount; i++) {
+        surfaces[i] = decodes[i].surface;
+        if (!surfaces[i]) success = false;
+    }
+
+    // Uploads happen here on the main thread, the renderer isn't thread safe
+    if (success) {
+        success = BuildAtlas(surfaces, textureCount);
+    }
+
+    for (int i = 0; i < textureCount; i++) {
+        if (surfaces[i]) SDL_FreeSurface(surfaces[i]);
+    }
+    return success;
+#endif
 }
 
+static SDL_Surface** s_SortSurfaces;
+
+static int CompareSurfaceHeight(const void* a, const void* b) {
+    int indexA = *(const int*)a;
+    int indexB = *(const int*)b;
+    int heightA = s_SortSurfaces[indexA]->h;
+    int heightB = s_SortSurfaces[indexB]->h;
+    if (heightA != heightB) return heightB - heightA;
+    return indexA - indexB;
+}
+
+// Packs the GAME_TEXTURES images into as few atlas pages as possible.
+// Images that don't fit on a page keep their own texture.
+bool ResourceManager::BuildAtlas(SDL_Surface** surfaces, int textureCount) {
+    SDL_RendererInfo info;
+    int pageSize = ATLAS_PAGE_SIZE;
+    if (SDL_GetRendererInfo(g_Engine.window->renderer, &info) == 0 && info.max_texture_width > 0) {
+        pageSize = std::min(pageSize, std::min(info.max_texture_width, info.max_texture_height));
+    }
+
+    // Tallest first packs a skyline much tighter
+    int order[TEXTURE_MAX];
+    for (int i = 0; i < textureCount; i++) order[i] = i;
+    s_SortSurfaces = surfaces;
+    qsort(order, textureCount, sizeof(int), CompareSurfaceHeight);
+
+    SkylinePacker packers[ATLAS_MAX_PAGES];
+    SDL_Rect rects[TEXTURE_MAX];
+    int pages[TEXTURE_MAX];
+    int pageCount = 0;
+
+    for (int n = 0; n < textureCount; n++) {
+        int i = order[n];
+        int paddedWidth = surfaces[i]->w + ATLAS_PADDING * 2;
+        int paddedHeight = surfaces[i]->h + ATLAS_PADDING * 2;
+        pages[i] = -1;
+
+        for (int page = 0; page < pageCount && pages[i] < 0; page++) {
+            if (packers[page].Pack(paddedWidth, paddedHeight, &rects[i])) pages[i] = page;
+        }
+        if (pages[i] < 0 && pageCount < ATLAS_MAX_PAGES && paddedWidth <= pageSize && paddedHeight <= pageSize) {
+            packers[pageCount].Init(pageSize, pageSize);
+            if (packers[pageCount].Pack(paddedWidth, paddedHeight, &rects[i])) pages[i] = pageCount;
+            pageCount++;
+        }
+
+        if (pages[i] >= 0) {
+            rects[i].x += ATLAS_PADDING;
+            rects[i].y += ATLAS_PADDING;
+            rects[i].w = surfaces[i]->w;
+            rects[i].h = surfaces[i]->h;
+        }
+    }
+
+    // Copy every packed image into its page and upload the pages
+    for (int page = 0; page < pageCount; page++) {
+        SDL_Surface* pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!pageSurface) {
+            printf("Failed to create atlas page! SDL Error: %s\n", SDL_GetError());
+            return false;
+        }
+        SDL_FillRect(pageSurface, NULL, 0);
+
+        for (int i = 0; i < textureCount; i++) {
+            if (pages[i] != page) continue;
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dest = rects[i];
+            SDL_BlitSurface(surfaces[i], NULL, pageSurface, &dest);
+        }
+
+        atlasPages[page] = SDL_CreateTextureFromSurface(g_Engine.window->renderer, pageSurface);
+        SDL_FreeSurface(pageSurface);
+        if (!atlasPages[page]) {
+            printf("Failed to create atlas page texture! SDL Error: %s\n", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(atlasPages[page], SDL_BLENDMODE_BLEND);
+        atlasPageCount = page + 1;
+    }
+
+    for (int i = 0; i < textureCount; i++) {
+        TextureID id = GAME_TEXTURES[i].id;
+        if (textures[id]) {
+            UnloadTexture(id);
+        }
+
+        if (pages[i] < 0) {
+            printf("Texture %s doesn't fit in the atlas, loading it on its own\n", GAME_TEXTURES[i].path);
+            textures[id] = CreateTexture(surfaces[i]);
+            if (!textures[id]) {
+                printf("Failed to load texture: %s\n", GAME_TEXTURES[i].path);
+                return false;
+            }
+            continue;
+        }
+
+        Texture* texture = new Texture();
+        texture->sdlTexture = atlasPages[pages[i]];
+        texture->width = rects[i].w;
+        texture->height = rects[i].h;
+        texture->atlasRect = rects[i];
+        texture->atlasPage = pages[i];
+        texture->pageWidth = pageSize;
+        texture->pageHeight = pageSize;
+        textures[id] = texture;
+    }
+
+    printf("Packed %d textures into %d atlas pages of %dx%d\n", textureCount, atlasPageCount, pageSize, pageSize);
+    return true;
+}
+
+// Only queues the decodes. A sound that fails to load stays silent instead
+// of stopping the game, nothing waits on it.
 bool ResourceManager::InitSounds() {
+#ifdef HEADLESS
+    return true;
+#else
     const int soundCount = sizeof(GAME_SOUNDS) / sizeof(GAME_SOUNDS[0]);
     for (int i = 0; i < soundCount; i++) {
-        if (!LoadSound(GAME_SOUNDS[i].path, GAME_SOUNDS[i].id)) {
-            printf("Failed to load sound: %s\n", GAME_SOUNDS[i].path);
-            return false;
-        }
+        SoundID id = GAME_SOUNDS[i].id;
+        UnloadSound(id);
+
+        SoundLoad* load = &s_SoundLoads[id];
+        load->path = GAME_SOUNDS[i].path;
+        load->chunk = nullptr;
+        SDL_AtomicSet(&load->counter.pending, 0);
+        JobSystem::SubmitBackground(DecodeSound, load, &load->counter);
     }
     return true;
+#endif
 }
 
 bool ResourceManager::InitFonts() {
+#ifdef HEADLESS
+    return true;
+#endif
     const int fontCount = sizeof(GAME_FONTS) / sizeof(GAME_FONTS[0]);
     for (int i = 0; i < fontCount; i++) {
         if (!LoadFont(GAME_FONTS[i].path, GAME_FONTS[i].size, GAME_FONTS[i].id)) {
@@ -305,8 +720,16 @@ void ResourceManager::UnloadAllResources() {
     for (int i = 1; i < FONT_MAX; i++) {
         UnloadFont((FontID)i);
     }
+
+    // Atlas pages go last, after every texture pointing into them
+    for (int i = 0; i < atlasPageCount; i++) {
+        SDL_DestroyTexture(atlasPages[i]);
+        atlasPages[i] = nullptr;
+    }
+    atlasPageCount = 0;
 }
 
+#ifndef HEADLESS
 void ResourceManager::PlayMusic(SoundID id, int loops) {
     Sound* sound = GetSound(id);
     if (!sound || !sound->sdlChunk) {
@@ -331,4 +754,22 @@ void ResourceManager::StopMusic() {
     Mix_HaltChannel(-1);
 }
 
+int ResourceManager::PlaySound(SoundID id, int volume, int loops) {
+    Sound* sound = GetSound(id);
+    if (!sound || !sound->sdlChunk) return -1;
+
+    if (volume >= 0) {
+        Mix_VolumeChunk(sound->sdlChunk, volume);
+    }
+    return Mix_PlayChannel(-1, sound->sdlChunk, loops);
+}
 
+void ResourceManager::HaltChannel(int channel) {
+    Mix_HaltChannel(channel);
+}
+#else
+void ResourceManager::PlayMusic(SoundID id, int loops) {}
+void ResourceManager::StopMusic() {}
+int ResourceManager::PlaySound(SoundID id, int volume, int loops) { return -1; }
+void ResourceManager::HaltChannel(int channel) {}
+#endif
@@ -1,20 +1,46 @@
 #pragma once
 
 #include <SDL.h>
+#ifndef HEADLESS
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
+#else
+// Headless builds only link SDL2 itself, fonts and sounds are never loaded
+typedef struct _TTF_Font TTF_Font;
+typedef struct Mix_Chunk Mix_Chunk;
+#endif
+#include "texture_atlas.h"
 
 // Forward declarations
 struct Texture {
     SDL_Texture* sdlTexture;
     int width;
     int height;
+    SDL_Rect atlasRect;         // Where the image sits inside sdlTexture
+    int atlasPage;              // Atlas page index, -1 if the texture owns sdlTexture
+    int pageWidth, pageHeight;  // Size of sdlTexture
+};
+
+#define FONT_FIRST_GLYPH 32   // Space
+#define FONT_LAST_GLYPH 126   // Tilde
+#define FONT_GLYPH_COUNT (FONT_LAST_GLYPH - FONT_FIRST_GLYPH + 1)
+#define FONT_ATLAS_SIZE 512
+#define MAX_TEXT_GLYPHS 256   // Longest string drawn in one call
+
+struct Glyph {
+    SDL_Rect rect;  // Position in the glyph atlas
+    int advance;    // How far the pen moves after this glyph
 };
 
 struct Font {
     TTF_Font* sdlFont;
     int size;
+
+    // Printable ASCII pre-rendered in white, tinted per draw with vertex colors
+    SDL_Texture* glyphAtlas;
+    int lineHeight;
+    Glyph glyphs[FONT_GLYPH_COUNT];
 };
 
 struct Sound {
@@ -151,6 +177,8 @@ struct ResourceManager {
     static Texture *GetTextTexture(Font *font, const char *text, SDL_Color color);
     static int RenderTextAlignedTopRight(Font* font, const char* text, SDL_Color color, int x, int y);
     static void RenderTextAlignedCenter(Font* font, const char* text, SDL_Color color, int x, int y);
+    static int MeasureText(Font* font, const char* text);
+    static void RenderText(Font* font, const char* text, SDL_Color color, int x, int y);
 
     // Sound management
     static Sound* LoadSound(const char* path);
@@ -165,12 +193,18 @@ struct ResourceManager {
     static Font* GetFont(FontID id);
     static void UnloadFont(FontID id);
 
-    // New initialization methods
+    // New initialization methods. Returns once the textures and fonts are
+    // resident, sounds keep decoding on the job threads.
     static bool InitAllResources();
     static void UnloadAllResources();
 
     // Music playback
     static void PlayMusic(SoundID id, int loops = -1);
+
+    // Sound effects. volume is 0-128 and sticks to the sound, -1 keeps it.
+    // Returns the channel playing it, or -1.
+    static int PlaySound(SoundID id, int volume = -1, int loops = 0);
+    static void HaltChannel(int channel);
     static void StopMusic();
     static void SetMusicVolume(int volume); // 0-128
 
@@ -180,8 +214,16 @@ private:
     static Sound* sounds[SOUND_MAX];
     static Font* fonts[FONT_MAX];
 
+    // Atlas pages shared by the GAME_TEXTURES entries
+    static SDL_Texture* atlasPages[ATLAS_MAX_PAGES];
+    static int atlasPageCount;
+
     // Helper methods for initialization
     static bool InitTextures();
     static bool InitSounds();
     static bool InitFonts();
+    static void FinishSoundLoad(SoundID id);
+    static Texture* CreateTexture(SDL_Surface* surface);
+    static bool BuildGlyphAtlas(Font* font);
+    static bool BuildAtlas(SDL_Surface** surfaces, int textureCount);
 }; 
\ No newline at end of file
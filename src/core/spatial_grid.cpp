@@ -0,0 +1,116 @@
+#include "spatial_grid.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void SpatialGrid::Init(float size) {
+    cellSize = size;
+    invCellSize = 1.0f / size;
+    Clear();
+}
+
+void SpatialGrid::Clear() {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        buckets[i] = -1;
+    }
+    nodeCount = 0;
+}
+
+void SpatialGrid::Destroy() {
+    free(nodes);
+    nodes = nullptr;
+    nodeCount = 0;
+    nodeCapacity = 0;
+}
+
+int SpatialGrid::CellCoord(float value) {
+    return (int)floorf(value * invCellSize);
+}
+
+int SpatialGrid::Bucket(int cellX, int cellY) {
+    uint32_t hash = ((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u);
+    return (int)(hash & (NUM_BUCKETS - 1));
+}
+
+bool SpatialGrid::Overlaps(const GridBox& a, const GridBox& b) {
+    return a.left < b.right && a.right > b.left &&
+           a.top < b.bottom && a.bottom > b.top;
+}
+
+void SpatialGrid::Insert(uint32_t id, const GridBox& box) {
+    int minX = CellCoord(box.left);
+    int maxX = CellCoord(box.right);
+    int minY = CellCoord(box.top);
+    int maxY = CellCoord(box.bottom);
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            if (nodeCount >= nodeCapacity) {
+                nodeCapacity = nodeCapacity ? nodeCapacity * 2 : 1024;
+                nodes = (Node*)realloc(nodes, nodeCapacity * sizeof(Node));
+            }
+
+            int bucket = Bucket(cx, cy);
+            Node* node = &nodes[nodeCount];
+            node->cellX = cx;
+            node->cellY = cy;
+            node->id = id;
+            node->box = box;
+            node->next = buckets[bucket];
+            buckets[bucket] = nodeCount;
+            nodeCount++;
+        }
+    }
+}
+
+void SpatialGrid::Remove(uint32_t id, const GridBox& box) {
+    int minX = CellCoord(box.left);
+    int maxX = CellCoord(box.right);
+    int minY = CellCoord(box.top);
+    int maxY = CellCoord(box.bottom);
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int* link = &buckets[Bucket(cx, cy)];
+            while (*link != -1) {
+                Node* node = &nodes[*link];
+                if (node->id == id && node->cellX == cx && node->cellY == cy) {
+                    *link = node->next;
+                    break;
+                }
+                link = &node->next;
+            }
+        }
+    }
+}
+
+int SpatialGrid::Query(const GridBox& box, uint32_t* results, int maxResults) {
+    int count = 0;
+    int minX = CellCoord(box.left);
+    int maxX = CellCoord(box.right);
+    int minY = CellCoord(box.top);
+    int maxY = CellCoord(box.bottom);
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            for (int n = buckets[Bucket(cx, cy)]; n != -1; n = nodes[n].next) {
+                const Node& node = nodes[n];
+                if (node.cellX != cx || node.cellY != cy) continue;  // Hash collision
+                if (!Overlaps(box, node.box)) continue;
+
+                // A pair overlapping in several cells is only reported from the
+                // cell holding the top-left corner of the overlap region
+                float overlapLeft = box.left > node.box.left ? box.left : node.box.left;
+                float overlapTop = box.top > node.box.top ? box.top : node.box.top;
+                if (CellCoord(overlapLeft) != cx || CellCoord(overlapTop) != cy) continue;
+
+                if (count >= maxResults) {
+                    return count;
+                }
+                results[count++] = node.id;
+            }
+        }
+    }
+
+    return count;
+}
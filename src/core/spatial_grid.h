@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// Axis-aligned box in world space (top-left origin, y grows downward)
+struct GridBox {
+    float left, top, right, bottom;
+};
+
+// Uniform grid stored as a spatial hash. Every occupied cell is hashed into a
+// fixed bucket table and entries are chained through a node pool, so the grid
+// covers any world size without allocating empty cells. A box is inserted into
+// every cell it overlaps. The node pool doubles when it runs out; it starts
+// empty when the grid is zero-initialized (globals, new SpatialGrid()).
+struct SpatialGrid {
+    static const int NUM_BUCKETS = 4096;  // Must be a power of two
+
+    struct Node {
+        int cellX, cellY;
+        uint32_t id;
+        GridBox box;
+        int next;  // Next node in the same bucket, -1 ends the chain
+    };
+
+    float cellSize;
+    float invCellSize;
+    int buckets[NUM_BUCKETS];
+    Node* nodes;
+    int nodeCount;
+    int nodeCapacity;
+
+    // Init and Clear keep the node pool, Destroy frees it
+    void Init(float size);
+    void Clear();
+    void Destroy();
+    void Insert(uint32_t id, const GridBox& box);
+
+    // Unlinks the nodes Insert made for id, box has to be the one it was
+    // inserted with. The nodes stay used in the pool until Clear.
+    void Remove(uint32_t id, const GridBox& box);
+
+    // Writes the ids of all boxes overlapping box into results, each id once.
+    // Returns the number of ids written (at most maxResults).
+    int Query(const GridBox& box, uint32_t* results, int maxResults);
+
+    static bool Overlaps(const GridBox& a, const GridBox& b);
+
+private:
+    int CellCoord(float value);
+    int Bucket(int cellX, int cellY);
+};
@@ -0,0 +1,99 @@
+#ifndef SPATIAL_GRID_BENCH_H
+#define SPATIAL_GRID_BENCH_H
+
+#include "spatial_grid.h"
+#include "engine_constants.h"
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DYNAMIC_COLLIDERS 5000
+#define BENCH_STATIC_COLLIDERS 2
+
+// Compares the old all-pairs collision loop against the grid broadphase used
+// by CollisionSystem, on the full level with the two walls from Game::Init.
+inline void BenchmarkSpatialGrid() {
+    printf("\n=== Broadphase benchmark: %d dynamic + %d static colliders ===\n",
+           BENCH_DYNAMIC_COLLIDERS, BENCH_STATIC_COLLIDERS);
+
+    const int total = BENCH_DYNAMIC_COLLIDERS + BENCH_STATIC_COLLIDERS;
+    GridBox* boxes = new GridBox[total];
+    bool* isStatic = new bool[total];
+
+    // Walls, same as Game::Init
+    boxes[0] = {0.0f, 0.0f, 50.0f, (float)GAME_HEIGHT};
+    boxes[1] = {2400.0f, 0.0f, 2450.0f, (float)GAME_HEIGHT};
+    isStatic[0] = isStatic[1] = true;
+
+    srand(5);
+    for (int i = BENCH_STATIC_COLLIDERS; i < total; i++) {
+        float size = 16.0f + (float)(rand() % 33);  // 16-48 px, around the squirrel's 32
+        float x = (float)(rand() % GAME_WIDTH);
+        float y = (float)(rand() % GAME_HEIGHT);
+        boxes[i] = {x, y, x + size, y + size};
+        isStatic[i] = false;
+    }
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    // Old path: every collider against every later one
+    Uint64 start = SDL_GetPerformanceCounter();
+    long long brutePairs = 0;
+    int bruteOverlaps = 0;
+    for (int a = 0; a < total; a++) {
+        for (int b = a + 1; b < total; b++) {
+            brutePairs++;
+            if (SpatialGrid::Overlaps(boxes[a], boxes[b])) bruteOverlaps++;
+        }
+    }
+    double bruteMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+    // Grid path: statics binned once (not timed, like CollisionSystem), dynamics
+    // re-binned every frame. Cell size matches CollisionSystem for 48 px colliders.
+    SpatialGrid* staticGrid = new SpatialGrid();
+    SpatialGrid* dynamicGrid = new SpatialGrid();
+    staticGrid->Init(64.0f);
+    for (int i = 0; i < total; i++) {
+        if (isStatic[i]) staticGrid->Insert(i, boxes[i]);
+    }
+
+    uint32_t candidates[1024];
+    start = SDL_GetPerformanceCounter();
+    long long gridPairs = 0;
+    int gridOverlaps = 0;
+    dynamicGrid->Init(64.0f);
+    for (int i = 0; i < total; i++) {
+        if (!isStatic[i]) dynamicGrid->Insert(i, boxes[i]);
+    }
+    for (int a = 0; a < total; a++) {
+        if (isStatic[a]) continue;
+
+        int count = staticGrid->Query(boxes[a], candidates, 1024);
+        for (int c = 0; c < count; c++) {
+            gridPairs++;
+            if (SpatialGrid::Overlaps(boxes[a], boxes[candidates[c]])) gridOverlaps++;
+        }
+
+        count = dynamicGrid->Query(boxes[a], candidates, 1024);
+        for (int c = 0; c < count; c++) {
+            if (candidates[c] <= (uint32_t)a) continue;
+            gridPairs++;
+            if (SpatialGrid::Overlaps(boxes[a], boxes[candidates[c]])) gridOverlaps++;
+        }
+    }
+    double gridMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+
+    printf("All pairs: %lld narrowphase pairs, %d overlaps, %.3f ms\n", brutePairs, bruteOverlaps, bruteMs);
+    printf("Grid:      %lld narrowphase pairs, %d overlaps, %.3f ms (%d static nodes, %d dynamic nodes)\n",
+           gridPairs, gridOverlaps, gridMs, staticGrid->nodeCount, dynamicGrid->nodeCount);
+    printf("Overlaps match: %s\n", bruteOverlaps == gridOverlaps ? "yes" : "NO");
+
+    staticGrid->Destroy();
+    dynamicGrid->Destroy();
+    delete staticGrid;
+    delete dynamicGrid;
+    delete[] boxes;
+    delete[] isStatic;
+}
+
+#endif // SPATIAL_GRID_BENCH_H
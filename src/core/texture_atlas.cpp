@@ -0,0 +1,95 @@
+#include "texture_atlas.h"
+#include <stdio.h>
+
+void SkylinePacker::Init(int pageWidth, int pageHeight) {
+    width = pageWidth;
+    height = pageHeight;
+    nodes[0] = {0, 0, pageWidth};
+    nodeCount = 1;
+}
+
+// Returns the y a w x h rectangle would sit at if its left edge starts at
+// node index, or -1 if it doesn't fit there
+int SkylinePacker::Fit(int index, int w, int h) {
+    int x = nodes[index].x;
+    if (x + w > width) return -1;
+
+    int y = nodes[index].y;
+    int remaining = w;
+    while (remaining > 0) {
+        if (index >= nodeCount) return -1;
+        if (nodes[index].y > y) y = nodes[index].y;
+        if (y + h > height) return -1;
+        remaining -= nodes[index].width;
+        index++;
+    }
+    return y;
+}
+
+bool SkylinePacker::Pack(int w, int h, SDL_Rect* result) {
+    int bestIndex = -1;
+    int bestY = height;
+    int bestWidth = width + 1;
+
+    for (int i = 0; i < nodeCount; i++) {
+        int y = Fit(i, w, h);
+        if (y < 0) continue;
+        if (y < bestY || (y == bestY && nodes[i].width < bestWidth)) {
+            bestIndex = i;
+            bestY = y;
+            bestWidth = nodes[i].width;
+        }
+    }
+
+    if (bestIndex < 0) return false;
+
+    if (nodeCount >= ATLAS_MAX_SKYLINE_NODES) {
+        printf("Warning: Atlas skyline is out of nodes\n");
+        return false;
+    }
+
+    *result = {nodes[bestIndex].x, bestY, w, h};
+    AddLevel(bestIndex, nodes[bestIndex].x, bestY, w, h);
+    return true;
+}
+
+void SkylinePacker::AddLevel(int index, int x, int y, int w, int h) {
+    // Insert the new top segment
+    for (int i = nodeCount; i > index; i--) {
+        nodes[i] = nodes[i - 1];
+    }
+    nodes[index] = {x, y + h, w};
+    nodeCount++;
+
+    // Shrink or drop the segments now covered by it
+    for (int i = index + 1; i < nodeCount; i++) {
+        int previousEnd = nodes[i - 1].x + nodes[i - 1].width;
+        if (nodes[i].x >= previousEnd) break;
+
+        int shrink = previousEnd - nodes[i].x;
+        nodes[i].x += shrink;
+        nodes[i].width -= shrink;
+        if (nodes[i].width > 0) break;
+
+        for (int j = i; j < nodeCount - 1; j++) {
+            nodes[j] = nodes[j + 1];
+        }
+        nodeCount--;
+        i--;
+    }
+
+    Merge();
+}
+
+void SkylinePacker::Merge() {
+    for (int i = 0; i < nodeCount - 1; i++) {
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].width += nodes[i + 1].width;
+            for (int j = i + 1; j < nodeCount - 1; j++) {
+                nodes[j] = nodes[j + 1];
+            }
+            nodeCount--;
+            i--;
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <SDL.h>
+
+#define ATLAS_PAGE_SIZE 2048       // Preferred atlas page size, clamped to the renderer limit
+#define ATLAS_MAX_PAGES 4
+#define ATLAS_PADDING 1            // Transparent gap between packed images
+#define ATLAS_MAX_SKYLINE_NODES 256
+
+// Skyline rectangle packer. The packed area is described by its top outline
+// (a list of horizontal segments), and each rectangle is placed where it ends
+// up lowest, ties broken by the narrowest segment.
+struct SkylinePacker {
+    struct Node {
+        int x, y, width;
+    };
+
+    int width, height;
+    Node nodes[ATLAS_MAX_SKYLINE_NODES];
+    int nodeCount;
+
+    void Init(int pageWidth, int pageHeight);
+
+    // Finds room for a w x h rectangle. Returns false if the page is full.
+    bool Pack(int w, int h, SDL_Rect* result);
+
+private:
+    int Fit(int index, int w, int h);
+    void AddLevel(int index, int x, int y, int w, int h);
+    void Merge();
+};
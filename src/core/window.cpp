@@ -1,7 +1,7 @@
 #include "window.h"
 #include <stdio.h>
 
-bool Window::Init(const char* title, int width, int height) {
+bool Window::Init(const char* title, int width, int height, bool vsync) {
     this->width = width;
     this->height = height;
     
@@ -19,10 +19,15 @@ bool Window::Init(const char* title, int width, int height) {
         return false;
     }
     
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    if (vsync) {
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+
     renderer = SDL_CreateRenderer(
         sdlWindow,
         -1,
-        SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+        rendererFlags
     );
     
     if (!renderer) {
@@ -9,7 +9,7 @@ struct Window {
     int height;
     
     // Initialize window
-    bool Init(const char* title, int width, int height);
+    bool Init(const char* title, int width, int height, bool vsync = true);
     
     // Cleanup window
     void Cleanup();
@@ -1,93 +1,81 @@
 #include "cloud_init.h"
 #include "../core/engine.h"
 #include "../core/resource_manager.h"
+#include "../core/ecs/prefab.h"
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
-void CreateCloudsFromData(const CloudInitData* cloudList, int count) {
-    for (int i = 0; i < count; i++) {
-        const CloudInitData& data = cloudList[i];
-        
-        Texture* tex = (data.type == CLOUD_WHITE) ? 
-            ResourceManager::GetTexture(TEXTURE_CLOUD_1) : ResourceManager::GetTexture(TEXTURE_BLACK_CLOUD_SMALL);
+#define CLOUD_PREFAB_COUNT 6  // Every CloudType x CloudSize
 
-        if (data.type == CLOUD_WHITE){
-            switch (data.size)
-            {
-            case CLOUD_SIZE_SMALL:
-                tex = ResourceManager::GetTexture(TEXTURE_WHITE_CLOUDE_SMALL);
-                break;
-            case CLOUD_SIZE_MEDIUM:
-                tex = ResourceManager::GetTexture(TEXTURE_WHITE_CLOUDE_MEDIUM);
-                break;
-            case CLOUD_SIZE_LARGE:
-                tex = ResourceManager::GetTexture(TEXTURE_WHITE_CLOUDE_LARGE);
-                break;
-            
-            default:
-                printf("invalid cloud size!\n");
-                break;
-            }
-        }
-
-        EntityID cloudEntity = g_Engine.entityManager.CreateEntity();
-        ADD_TRANSFORM(cloudEntity, data.x, data.y, 0, 1);
-        ADD_SPRITE(cloudEntity, tex);
-        ADD_CLOUD(cloudEntity, data.type, data.size);
-    }
+static int CloudPrefabIndex(CloudType type, CloudSize size) {
+    return type * 3 + size;
 }
 
-float GetCloudDensityMultiplier(float y) {
-    // Returns a value between 3.0 and 1.0 based on depth
-    // Less clouds as you go deeper (higher y values)
-    float depthRatio = y / GAME_HEIGHT;
-    return 3.0f - (depthRatio * 2.0f); // Linear decrease down to 1x density
-}
+// Built once by InitCloudPrefabs, every spawn only stamps them out
+static Prefab cloudPrefabs[CLOUD_PREFAB_COUNT];
 
-void GenerateRandomClouds(float playerStartY) {
-    srand(5); // Initialize seed
+void InitCloudPrefabs() {
+    // One prefab per cloud look, so each texture is looked up once
+    static const TextureID whiteTextures[] = {
+        TEXTURE_WHITE_CLOUDE_SMALL,
+        TEXTURE_WHITE_CLOUDE_MEDIUM,
+        TEXTURE_WHITE_CLOUDE_LARGE
+    };
+    for (int type = CLOUD_WHITE; type <= CLOUD_BLACK; type++) {
+        for (int size = CLOUD_SIZE_SMALL; size <= CLOUD_SIZE_LARGE; size++) {
+            Prefab* prefab = &cloudPrefabs[CloudPrefabIndex((CloudType)type, (CloudSize)size)];
+            TextureID textureId = (type == CLOUD_WHITE) ? whiteTextures[size] : TEXTURE_BLACK_CLOUD_SMALL;
 
-    // Create an array to store cloud data
-    CloudInitData clouds[MAX_CLOUDS];
-    int cloudCount = 0;
+            prefab->Init(COMPONENT_TRANSFORM | COMPONENT_SPRITE | COMPONENT_CLOUD);
+            prefab->sprite.Init(ResourceManager::GetTexture(textureId), true);
+            prefab->cloud.Init((CloudType)type, (CloudSize)size);
+        }
+    }
+}
 
-    // Generate clouds for each vertical section
-    for (float y = playerStartY; y < (GAME_HEIGHT- WINDOW_HEIGHT*3) && cloudCount < MAX_CLOUDS; y += WINDOW_HEIGHT) {
-        // Calculate how many clouds to place in this section
-        float densityMultiplier = GetCloudDensityMultiplier(y);
-        int cloudsInSection = (int)(CLOUDS_PER_SECTION * densityMultiplier);
+int CreateCloudsFromData(const CloudInitData* cloudList, int count, EntityID* spawned) {
+    // Sort the positions by prefab, then spawn each group in one batch.
+    // listIndex remembers where each position came from for spawned.
+    static SDL_FPoint positions[CLOUD_PREFAB_COUNT][MAX_CLOUDS];
+    static int listIndex[CLOUD_PREFAB_COUNT][MAX_CLOUDS];
+    static EntityID batch[MAX_CLOUDS];
+    int positionCounts[CLOUD_PREFAB_COUNT] = {0};
 
-        // Generate clouds for this section
-        for (int i = 0; i < cloudsInSection && cloudCount < MAX_CLOUDS; i++) {
-            CloudInitData cloud;
-            
-            // Random position within game width and current height section
-            cloud.x = (float)(rand() % GAME_WIDTH);
-            cloud.y = y + (float)(rand() % WINDOW_HEIGHT);
+    int dropped = 0;
+    for (int i = 0; i < count; i++) {
+        const CloudInitData& data = cloudList[i];
+        if ((int)data.size < CLOUD_SIZE_SMALL || (int)data.size > CLOUD_SIZE_LARGE) {
+            printf("invalid cloud size!\n");
+            continue;
+        }
+        if ((int)data.type < CLOUD_WHITE || (int)data.type > CLOUD_BLACK) {
+            printf("invalid cloud type!\n");
+            continue;
+        }
 
-            // Determine cloud type (20% chance for black clouds) - CHANGED - ONLY WHITE CLOUDS
-            cloud.type = CLOUD_WHITE;//(rand() % 5 == 0) ? CLOUD_BLACK : CLOUD_WHITE; 
-            cloud.size = (cloud.type == CLOUD_BLACK) ? CLOUD_SIZE_SMALL : (CloudSize) (rand()%3) ;
+        int index = CloudPrefabIndex(data.type, data.size);
+        if (positionCounts[index] < MAX_CLOUDS) {
+            listIndex[index][positionCounts[index]] = i;
+            positions[index][positionCounts[index]++] = {data.x, data.y};
+        } else {
+            dropped++;
+        }
+    }
+    if (dropped > 0) {
+        printf("Warning: more than %d clouds of one kind, skipped %d\n", MAX_CLOUDS, dropped);
+    }
 
-            // Check minimum spacing with previously placed clouds
-            bool tooClose = false;
-            for (int j = 0; j < cloudCount; j++) {
-                float dx = cloud.x - clouds[j].x;
-                float dy = cloud.y - clouds[j].y;
-                float distSq = dx * dx + dy * dy;
-                if (distSq < MIN_CLOUD_SPACING * MIN_CLOUD_SPACING) {
-                    tooClose = true;
-                    break;
-                }
-            }
+    if (spawned) {
+        memset(spawned, 0, count * sizeof(EntityID));
+    }
 
-            // If cloud placement is valid, add it to the array
-            if (!tooClose) {
-                clouds[cloudCount++] = cloud;
-            }
+    int spawnedCount = 0;
+    for (int i = 0; i < CLOUD_PREFAB_COUNT; i++) {
+        int created = SpawnBatch(&cloudPrefabs[i], positions[i], positionCounts[i], batch);
+        for (int b = 0; spawned && b < created; b++) {
+            spawned[listIndex[i][b]] = batch[b];
         }
+        spawnedCount += created;
     }
-
-    // Create all the clouds
-    CreateCloudsFromData(clouds, cloudCount);
-} 
\ No newline at end of file
+    return spawnedCount;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../core/ecs/components/cloud_components.h"
+#include "../core/ecs/ecs_types.h"
 
 struct CloudInitData {
     float x;
@@ -19,10 +20,13 @@ const CloudInitData cloudList[] = {
 // Constants for cloud generation
 #define MIN_CLOUD_SPACING 100.0f         // Minimum distance between clouds
 #define CLOUDS_PER_SECTION 5             // Base number of clouds per window height
-#define MAX_CLOUDS 1000                  // Maximum number of clouds to generate
+#define MAX_CLOUDS 1000                  // Most clouds spawned by one CreateCloudsFromData call
+#define MAX_CLOUDS_PER_CHUNK (CLOUDS_PER_SECTION * 3)  // Density multiplier tops out at 3
 
 
 // Helper functions
-void CreateCloudsFromData(const CloudInitData* cloudList, int count);
-void GenerateRandomClouds(float playerStartY);
-float GetCloudDensityMultiplier(float y); // Returns higher values as y increases
\ No newline at end of file
+// Builds the cloud prefabs, once the textures are loaded and before any spawn
+void InitCloudPrefabs();
+// The ID of each spawned cloud is written to spawned at its list index if
+// given, 0 for skipped entries. Returns how many were spawned.
+int CreateCloudsFromData(const CloudInitData* cloudList, int count, EntityID* spawned = nullptr);
@@ -2,8 +2,10 @@
 #include "../core/resource_manager.h"
 #include "../core/window.h"
 #include "../core/input.h"
+#include "../core/profiler.h"
 #include "cloud_init.h"
 #include "peanut_init.h"
+#include "level_stream.h"
 #include <math.h>
 
 Game g_Game;
@@ -18,22 +20,25 @@ bool Game::Init() {
     peanutSystem.Init();
     collisionSystem.Init();
     musicSystem.Init();
+    animationSystem.Init();
     
     
-    g_Engine.systemManager.RegisterSystem(&backgroundSystem);
-    g_Engine.systemManager.RegisterSystem(&renderSystem);
-    g_Engine.systemManager.RegisterSystem(&squirrelSystem);
-    g_Engine.systemManager.RegisterSystem(&cameraSystem);
-    g_Engine.systemManager.RegisterSystem(&cloudSystem);
-    g_Engine.systemManager.RegisterSystem(&peanutSystem);
-    g_Engine.systemManager.RegisterSystem(&collisionSystem);
-    g_Engine.systemManager.RegisterSystem(&musicSystem);
+    g_Engine.systemManager.RegisterSystem(&backgroundSystem, SYSTEM_PHASE_RENDER, "BackgroundSystem");
+    g_Engine.systemManager.RegisterSystem(&renderSystem, SYSTEM_PHASE_RENDER, "RenderSystem");
+    g_Engine.systemManager.RegisterSystem(&squirrelSystem, SYSTEM_PHASE_FIXED, "SquirrelPhysics");
+    g_Engine.systemManager.RegisterSystem(&cameraSystem, SYSTEM_PHASE_FIXED, "CameraSystem");
+    g_Engine.systemManager.RegisterSystem(&cloudSystem, SYSTEM_PHASE_FIXED, "CloudSystem");
+    g_Engine.systemManager.RegisterSystem(&peanutSystem, SYSTEM_PHASE_FIXED, "PeanutSystem");
+    g_Engine.systemManager.RegisterSystem(&collisionSystem, SYSTEM_PHASE_FIXED, "CollisionSystem");
+    g_Engine.systemManager.RegisterSystem(&musicSystem, SYSTEM_PHASE_FIXED, "MusicSystem");
+    g_Engine.systemManager.RegisterSystem(&animationSystem, SYSTEM_PHASE_FIXED, "AnimationSystem");
 
     // Create background
     backgroundEntity = g_Engine.entityManager.CreateEntity();
     Texture* backgroundTexture = ResourceManager::GetTexture(TEXTURE_BACKGROUND_MIDDLE);
     ADD_TRANSFORM(backgroundEntity, -600.0f, 0.0f, 0.0f, 1.0f);
     ADD_SPRITE(backgroundEntity, backgroundTexture);
+    g_Engine.componentArrays.sprites[backgroundEntity].layer = RENDER_LAYER_BACKGROUND;
     ADD_BACKGROUND(backgroundEntity, 0.5f);  // 0.5 parallax factor for medium depth
 
     // Create bottom background
@@ -41,14 +46,18 @@ bool Game::Init() {
     Texture* bottomTexture = ResourceManager::GetTexture(TEXTURE_BACKGROUND_BOTTOM);
     ADD_TRANSFORM(bottomBackgroundEntity, 800.0f, GAME_HEIGHT , 0.0f, 1.0f);
     ADD_SPRITE(bottomBackgroundEntity, bottomTexture);
+    g_Engine.componentArrays.sprites[bottomBackgroundEntity].layer = RENDER_LAYER_BACKGROUND;
     ADD_BACKGROUND(bottomBackgroundEntity, 0.5f);
+    // Two whole images swapped every 250ms
+    static const TextureID bottomFrames[] = { TEXTURE_BACKGROUND_BOTTOM, TEXTURE_BACKGROUND_BOTTOM_2 };
+    ADD_ANIMATION(bottomBackgroundEntity, AnimationSheets::FromTextures(bottomFrames, 2), 0.25f, true);
 
     EntityID Wall_left = g_Engine.entityManager.CreateEntity();
     Texture* spriteTex = ResourceManager::GetTexture(TEXTURE_WALL);
     ADD_TRANSFORM(Wall_left, 0, 0, 0.0f, 1.0f);
     ADD_COLLIDER(Wall_left, 50, GAME_HEIGHT, true, false);
     // ADD_SPRITE(Wall_left, spriteTex);
-    // SpriteComponent *wall_sprite = &g_Engine.componentArrays.sprites[Wall_left];
+    // SpriteRef wall_sprite = g_Engine.componentArrays.sprites[Wall_left];
     // wall_sprite->width = 32;
     // wall_sprite->height= GAME_HEIGHT;
 
@@ -56,7 +65,7 @@ bool Game::Init() {
     ADD_TRANSFORM(Wall_right, 2400, 0, 0.0f, 1.0f);
     ADD_COLLIDER(Wall_right, 50, GAME_HEIGHT, true, false);
     // ADD_SPRITE(Wall_right, spriteTex);
-    // SpriteComponent *wall_right_sprite = &g_Engine.componentArrays.sprites[Wall_right];
+    // SpriteRef wall_right_sprite = g_Engine.componentArrays.sprites[Wall_right];
     // wall_right_sprite->width = 32;
     // wall_right_sprite->height= GAME_HEIGHT;
 
@@ -65,6 +74,7 @@ bool Game::Init() {
     Texture* helicopterTexture = ResourceManager::GetTexture(TEXTURE_HELICOPTER);
     ADD_TRANSFORM(helicopterEntity, 1200.0f, 100.0f, 0.0f, 1.0f);  // Position above squirrel
     ADD_SPRITE(helicopterEntity, helicopterTexture);
+    g_Engine.componentArrays.sprites[helicopterEntity].layer = RENDER_LAYER_FOREGROUND;
 
     // Create squirrel entity
     squirrelEntity = g_Engine.entityManager.CreateEntity();
@@ -74,6 +84,7 @@ bool Game::Init() {
     ADD_TRANSFORM(squirrelEntity, 1200.0f, 100.0f, 0.0f, 1.0f);  // Center-top of screen
     ADD_SQUIRREL(squirrelEntity);
     ADD_SPRITE(squirrelEntity, squirrelTexture);
+    g_Engine.componentArrays.sprites[squirrelEntity].layer = RENDER_LAYER_FOREGROUND;
     ADD_COLLIDER(squirrelEntity, 32, 32, 0, 0);
 
     // create camera
@@ -83,13 +94,14 @@ bool Game::Init() {
 
     Reset();
 
-    // Create manual clouds
-    CreateCloudsFromData(cloudList, sizeof(cloudList) / sizeof(CloudInitData));
-    
-    float cloudSpawnThreshold = 500; 
-    GenerateRandomClouds(cloudSpawnThreshold);
-
-    GenerateRandomPeanuts(500.0f);  // Use same threshold as clouds
+    // Clouds and peanuts are streamed in chunks around the camera, from the
+    // level file if there is one. Their prefabs are set up once for all chunks.
+    InitCloudPrefabs();
+    InitPeanutPrefabs();
+    LevelStream::Init(levelSeed, levelPath);
+    LevelStream::SpawnStaticClouds();
+    LevelStream::Update(g_Engine.componentArrays.cameras[cameraEntity].y);
+    UpdatePeanutTargets();
 
     // Store IDs for later use
     hitSoundID = SOUND_HIT;
@@ -100,14 +112,10 @@ bool Game::Init() {
 
 
     // Position squirrel below helicopter
-    TransformComponent* heliTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(helicopterEntity, COMPONENT_TRANSFORM);
-    SpriteComponent* heliSprite = 
-        (SpriteComponent*)g_Engine.componentArrays.GetComponentData(helicopterEntity, COMPONENT_SPRITE);
+    TransformRef heliTransform = g_Engine.componentArrays.transforms[helicopterEntity];
     
     // Adjust squirrel starting position to be just below helicopter
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
     squirrelTransform->x = heliTransform->x;
     squirrelTransform->y = heliTransform->y + 30;
 
@@ -120,6 +128,7 @@ bool Game::Init() {
     Texture* arrowTexture = ResourceManager::GetTexture(TEXTURE_ARROW);
     ADD_TRANSFORM(arrowEntity, 0.0f, 0.0f, 0.0f, 1.0f);
     ADD_SPRITE(arrowEntity, arrowTexture);
+    g_Engine.componentArrays.sprites[arrowEntity].layer = RENDER_LAYER_FOREGROUND;
 
     return true;
 }
@@ -129,10 +138,7 @@ void Game::HandleInput(){
 
     // Play sound on mouse click
     if (Input::mouseButtonsPressed[0]) {  // Left click
-        Sound* hitSound = ResourceManager::GetSound(hitSoundID);
-        if (hitSound) {
-            Mix_PlayChannel(-1, hitSound->sdlChunk, 0);
-        }
+        ResourceManager::PlaySound(hitSoundID);
     }
     
     // Add reset on 'R' key press
@@ -146,15 +152,14 @@ void Game::Update(float deltaTime) {
 
     // Get squirrel position
     SquirrelComponent *squirrel =
-        (SquirrelComponent *)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, squirrelEntity);
 
 
     if (gameState == GAME_STATE_PLAYING && squirrel->state != SQUIRREL_STATE_DROPPING) {
         gameTimer += deltaTime;
 
         // Get squirrel position
-        TransformComponent *squirrelTransform =
-            (TransformComponent *)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
+        TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
 
         static bool playVictoryOnce = false;
 
@@ -162,8 +167,7 @@ void Game::Update(float deltaTime) {
         if (squirrelTransform->y >= GAME_HEIGHT + 400) {  // Leave some margin at bottom
             gameState = GAME_STATE_FINISHED;
 
-            SpriteComponent *squirrelSprite =
-                (SpriteComponent *)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SPRITE);
+            SpriteRef squirrelSprite = g_Engine.componentArrays.sprites[squirrelEntity];
             squirrelSprite->isVisible = 0;
 
             // Check if this is a new record
@@ -173,10 +177,7 @@ void Game::Update(float deltaTime) {
             }
 
             if (!playVictoryOnce) {
-                Sound* victorySound = ResourceManager::GetSound(SOUND_VICTORY);
-                if (victorySound) {
-                    Mix_PlayChannel(-1, victorySound->sdlChunk, 0);
-                }
+                ResourceManager::PlaySound(SOUND_VICTORY);
                 playVictoryOnce = true;
             }
 
@@ -185,16 +186,27 @@ void Game::Update(float deltaTime) {
         }
     }
 
+    // Bring in the level around the camera before anything looks at it
+    if (LevelStream::Update(g_Engine.componentArrays.cameras[cameraEntity].y)) {
+        UpdatePeanutTargets();
+    }
+
     UpdateArrowDirection();
+
+    // Gameplay and physics systems tick at the fixed step
+    g_Engine.systemManager.UpdateSystems(SYSTEM_PHASE_FIXED, deltaTime, &g_Engine.entityManager, &g_Engine.componentArrays);
 }
 
 void Game::Render() {
     // Systems will handle rendering of entities
-    g_Engine.systemManager.UpdateSystems(g_Engine.deltaTime, &g_Engine.entityManager, &g_Engine.componentArrays);
+    g_Engine.systemManager.UpdateSystems(SYSTEM_PHASE_RENDER, g_Engine.deltaTime, &g_Engine.entityManager, &g_Engine.componentArrays);
+
+    // Everything below is HUD
+    PROFILE_SCOPE("HUD");
     
     // Get squirrel state for instructions
     SquirrelComponent* squirrel = 
-        (SquirrelComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, squirrelEntity);
 
     // Render instructions if squirrel is in dropping state
     if (squirrel && squirrel->state == SQUIRREL_STATE_DROPPING) {
@@ -220,8 +232,7 @@ void Game::Render() {
     }
     
     // Get squirrel position for height calculation
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
 
     // Calculate remaining height (in hundreds of pixels)
     float remainingHeight = (GAME_HEIGHT - squirrelTransform->y) / 100.0f;
@@ -233,12 +244,15 @@ void Game::Render() {
     char speedText[32];
     char currentSpeedText[32];
     char posText[32];
+    char spritesText[64];
     snprintf(fpsText, sizeof(fpsText), "FPS: %.1f", 1.0f / g_Engine.deltaTime);
     snprintf(timerText, sizeof(timerText), "Time: %.2f", gameTimer);
     snprintf(heightText, sizeof(heightText), "Height: %.0f", remainingHeight);
     snprintf(speedText, sizeof(speedText), "Max speed: %.0f", squirrel->maxSpeed);
     snprintf(currentSpeedText, sizeof(currentSpeedText), "Speed: %.0f", squirrel->velocityY);
     snprintf(posText, sizeof(posText), "Pos: %.0f, %.0f", squirrelTransform->x, squirrelTransform->y);
+    snprintf(spritesText, sizeof(spritesText), "Sprites: %d drawn, %d culled, %d batches",
+        renderSystem.spritesSubmitted, renderSystem.spritesCulled, renderSystem.queue.batchCount);
 
     SDL_Color textColor = {255, 255, 255, 255};  // White color
     Font* fpsFont = ResourceManager::GetFont(fpsFontID);
@@ -261,6 +275,9 @@ void Game::Render() {
         // Render position below current speed
         ResourceManager::RenderTextAlignedTopRight(fpsFont, posText, textColor, 
             g_Engine.window->width - 10, 110);
+        // Render culling stats below position
+        ResourceManager::RenderTextAlignedTopRight(fpsFont, spritesText, textColor, 
+            g_Engine.window->width - 10, 130);
         
         // If game is finished, show completion message
         if (gameState == GAME_STATE_FINISHED) {
@@ -268,7 +285,7 @@ void Game::Render() {
             snprintf(finishText, sizeof(finishText), "FINISHED! Time: %.2f", gameTimer);
 
             SquirrelComponent *squirrel =
-                (SquirrelComponent *)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SQUIRREL);
+                g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, squirrelEntity);
 
             squirrel->state = SQUIRREL_STATE_DROPPING;
 
@@ -305,7 +322,7 @@ void Game::Render() {
     SDL_RenderDrawRect(g_Engine.window->renderer, &barRect);
     
     // Calculate squirrel's progress
-    if (squirrelTransform) {
+    if (g_Engine.entityManager.IsEntityValid(squirrelEntity)) {
         // Calculate position on bar (invert because y increases downward)
         float progress = (squirrelTransform->y / GAME_HEIGHT);
         float markerY = BAR_TOP_MARGIN + (BAR_HEIGHT * progress);
@@ -330,7 +347,7 @@ void Game::Render() {
             SDL_RenderCopyEx(
                 g_Engine.window->renderer,
                 squirrelTexture->sdlTexture,
-                NULL,
+                &squirrelTexture->atlasRect,
                 &destRect,
                 0,      // No rotation
                 NULL,   // Rotate around center
@@ -342,6 +359,7 @@ void Game::Render() {
 
 void Game::Cleanup() {
     // Cleanup entities
+    LevelStream::Destroy();
     g_Engine.entityManager.DestroyEntity(squirrelEntity);
     
     // Resources will be cleaned up by ResourceManager
@@ -352,25 +370,22 @@ void Game::Reset() {
     gameState = GAME_STATE_PLAYING;
 
     // Reset squirrel sprite
-    SpriteComponent* squirrelSprite = 
-        (SpriteComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SPRITE);
-    squirrelSprite->texture = ResourceManager::GetTexture(TEXTURE_SQUIRREL_SITTING);
+    SpriteRef squirrelSprite = g_Engine.componentArrays.sprites[squirrelEntity];
+    squirrelSprite->ChangeTexture(ResourceManager::GetTexture(TEXTURE_SQUIRREL_SITTING));
     squirrelSprite->isVisible=1;
 
     gameTimer = 0.0f;
     isNewRecord = false;
     
     // Reset helicopter position
-    TransformComponent* heliTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(helicopterEntity, COMPONENT_TRANSFORM);
+    TransformRef heliTransform = g_Engine.componentArrays.transforms[helicopterEntity];
     heliTransform->x = 1200.0f;
     heliTransform->y = 100.0f;
     
     // Reset squirrel position and state  
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
     SquirrelComponent* squirrel = 
-        (SquirrelComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_SQUIRREL);
+        g_Engine.componentArrays.Find<SquirrelComponent>(&g_Engine.entityManager, squirrelEntity);
         
     
     // Position squirrel below helicopter
@@ -383,18 +398,36 @@ void Game::Reset() {
     squirrel->velocityY = 0;
     squirrel->rotation = 0;
     
-    // Reset all peanuts
+    // Don't interpolate the jump back to the helicopter
+    squirrelTransform->SavePrevious();
+    
+    // Reset all peanuts, the live ones and the ones chunks remember
+    LevelStream::ResetCollected();
     MakeAllPeanutsVisibleAgain();
+    UpdatePeanutTargets();
 
     // resets squirrel stats
     squirrel->Init();
 }
 
+void Game::UpdatePeanutTargets() {
+    // The arrow can only point at peanuts in the streamed in chunks
+    numPeanutTargets = 0;
+    EntityView* view = g_Engine.entityManager.View(COMPONENT_PEANUT | COMPONENT_TRANSFORM);
+    for (uint32_t v = 0; v < view->dense.count && numPeanutTargets < MAX_PEANUT_TARGETS; v++) {
+        EntityID entity = view->dense[v];
+        TransformRef transform = g_Engine.componentArrays.transforms[entity];
+
+        peanutTargets[numPeanutTargets].x = transform->x;
+        peanutTargets[numPeanutTargets].y = transform->y;
+        peanutTargets[numPeanutTargets].isCollected = g_Engine.componentArrays.peanuts[entity].wasCollected;
+        numPeanutTargets++;
+    }
+}
+
 void Game::UpdateArrowDirection() {
-    TransformComponent* squirrelTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(squirrelEntity, COMPONENT_TRANSFORM);
-    TransformComponent* arrowTransform = 
-        (TransformComponent*)g_Engine.componentArrays.GetComponentData(arrowEntity, COMPONENT_TRANSFORM);
+    TransformRef squirrelTransform = g_Engine.componentArrays.transforms[squirrelEntity];
+    TransformRef arrowTransform = g_Engine.componentArrays.transforms[arrowEntity];
     
     // Find closest uncollected peanut below squirrel
     float closestDist = FLT_MAX;
@@ -427,8 +460,7 @@ void Game::UpdateArrowDirection() {
         arrowTransform->rotation = angle;
         
         // Make arrow visible
-        SpriteComponent* arrowSprite = 
-            (SpriteComponent*)g_Engine.componentArrays.GetComponentData(arrowEntity, COMPONENT_SPRITE);
+        SpriteRef arrowSprite = g_Engine.componentArrays.sprites[arrowEntity];
         arrowSprite->isVisible = true;
     }
 }
@@ -11,6 +11,7 @@
 #include "../core/ecs/systems/background_system.h"
 #include "../core/ecs/systems/peanut_system.h"
 #include "../core/ecs/systems/music_system.h"
+#include "../core/ecs/systems/animation_system.h"
 
 enum GameState {
     GAME_STATE_PLAYING,
@@ -32,10 +33,14 @@ public:
     void Cleanup();
     void Reset();
 
-    void UpdatePeanutTargets();  // Call this when peanuts are collected
+    void UpdatePeanutTargets();  // Call this when peanuts are spawned, recycled or reset
     void UpdateArrowDirection();  // Call this each frame
 
     
+    // Set before Init: a baked level to load, otherwise levelSeed picks the layout
+    const char* levelPath;
+    uint32_t levelSeed;
+
     EntityID squirrelEntity;
     EntityID helicopterEntity;
     EntityID cameraEntity;
@@ -58,6 +63,7 @@ private:
     BackgroundSystem backgroundSystem;
     PeanutSystem peanutSystem;
     MusicSystem musicSystem;
+    AnimationSystem animationSystem;
     
     // Entities
     EntityID backgroundEntity;
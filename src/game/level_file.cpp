@@ -0,0 +1,181 @@
+#include "level_file.h"
+#include "level_gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool LevelFile::Open(const char* path) {
+    header = nullptr;
+    data = nullptr;
+    size = 0;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("Failed to open level %s\n", path);
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    }
+    if (mapping) {
+        // The view keeps the mapping alive on its own
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    size = data ? (size_t)fileSize.QuadPart : 0;
+#elif defined(__EMSCRIPTEN__)
+    // Preloaded assets already sit in memory, a copy is as good as a mapping
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Failed to open level %s\n", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize > 0) {
+        data = malloc(fileSize);
+        if (data && fread(data, 1, fileSize, file) != (size_t)fileSize) {
+            free(data);
+            data = nullptr;
+        }
+    }
+    fclose(file);
+    size = data ? (size_t)fileSize : 0;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0) {
+        printf("Failed to open level %s\n", path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) data = nullptr;
+    }
+    close(file);  // The mapping stays valid
+    size = data ? (size_t)info.st_size : 0;
+#endif
+
+    if (!data) {
+        printf("Failed to map level %s\n", path);
+        return false;
+    }
+
+    if (!Validate(path)) {
+        Close();
+        return false;
+    }
+
+    LevelFileLayout layout;
+    layout.Init(header);
+    const uint8_t* bytes = (const uint8_t*)data;
+    staticClouds = (const CloudInitData*)(bytes + layout.staticClouds);
+    chunks = (const LevelFileChunk*)(bytes + layout.chunks);
+    clouds = (const CloudInitData*)(bytes + layout.clouds);
+    peanuts = (const PeanutInitData*)(bytes + layout.peanuts);
+
+    printf("Loaded level %s: %u chunks, %u clouds, %u peanuts\n",
+           path, header->chunkCount, header->cloudCount, header->peanutCount);
+    return true;
+}
+
+bool LevelFile::Validate(const char* path) {
+    const LevelFileHeader* fileHeader = (const LevelFileHeader*)data;
+    if (size < sizeof(LevelFileHeader) || memcmp(fileHeader->magic, LEVEL_FILE_MAGIC, 4) != 0 ||
+        fileHeader->version != LEVEL_FILE_VERSION) {
+        printf("%s is not a version %d level file\n", path, LEVEL_FILE_VERSION);
+        return false;
+    }
+
+    // Chunks are streamed by position, so they have to line up with ours
+    if (fileHeader->startY != LEVEL_START_Y || fileHeader->chunkHeight != LEVEL_CHUNK_HEIGHT) {
+        printf("%s was baked for %.0fpx chunks from y=%.0f, expected %dpx from y=%.0f\n", path,
+               fileHeader->chunkHeight, fileHeader->startY, LEVEL_CHUNK_HEIGHT, LEVEL_START_Y);
+        return false;
+    }
+
+    // Counts are 32 bit and the layout sums are 64 bit on every target, so
+    // they can't overflow. Only then is it safe to compare with the size.
+    LevelFileLayout layout;
+    layout.Init(fileHeader);
+    if (layout.size > (uint64_t)size) {
+        printf("%s is truncated: %lu bytes, tables need %llu\n", path,
+               (unsigned long)size, (unsigned long long)layout.size);
+        return false;
+    }
+
+    // Spawned in one CreateCloudsFromData call at startup
+    if (fileHeader->staticCloudCount > MAX_CLOUDS) {
+        printf("%s has %u static clouds, at most %d are supported\n", path, fileHeader->staticCloudCount, MAX_CLOUDS);
+        return false;
+    }
+
+    const LevelFileChunk* fileChunks = (const LevelFileChunk*)((const uint8_t*)data + layout.chunks);
+    for (uint32_t i = 0; i < fileHeader->chunkCount; i++) {
+        const LevelFileChunk& chunk = fileChunks[i];
+        if ((uint64_t)chunk.firstCloud + chunk.cloudCount > fileHeader->cloudCount ||
+            (uint64_t)chunk.firstPeanut + chunk.peanutCount > fileHeader->peanutCount ||
+            chunk.cloudCount > MAX_CLOUDS_PER_CHUNK || chunk.peanutCount > MAX_PEANUTS_PER_CHUNK) {
+            printf("%s: chunk %u is out of range\n", path, i);
+            return false;
+        }
+    }
+
+    // The spawners index prefab tables with these
+    const uint8_t* bytes = (const uint8_t*)data;
+    const CloudInitData* cloudTables[2] = {
+        (const CloudInitData*)(bytes + layout.staticClouds),
+        (const CloudInitData*)(bytes + layout.clouds)
+    };
+    const uint32_t cloudTableCounts[2] = { fileHeader->staticCloudCount, fileHeader->cloudCount };
+    for (int table = 0; table < 2; table++) {
+        for (uint32_t i = 0; i < cloudTableCounts[table]; i++) {
+            const CloudInitData& cloud = cloudTables[table][i];
+            if ((int)cloud.type < CLOUD_WHITE || (int)cloud.type > CLOUD_BLACK ||
+                (int)cloud.size < CLOUD_SIZE_SMALL || (int)cloud.size > CLOUD_SIZE_LARGE) {
+                printf("%s: cloud %u has an invalid type or size\n", path, i);
+                return false;
+            }
+        }
+    }
+    const PeanutInitData* filePeanuts = (const PeanutInitData*)(bytes + layout.peanuts);
+    for (uint32_t i = 0; i < fileHeader->peanutCount; i++) {
+        int type = filePeanuts[i].type;
+        if (type < 0 || type >= PEANUT_PREFAB_COUNT) {
+            printf("%s: peanut %u has an invalid type\n", path, i);
+            return false;
+        }
+    }
+
+    header = fileHeader;
+    return true;
+}
+
+void LevelFile::Close() {
+    if (data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#elif defined(__EMSCRIPTEN__)
+        free(data);
+#else
+        munmap(data, size);
+#endif
+    }
+    header = nullptr;
+    data = nullptr;
+    size = 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "cloud_init.h"
+#include "peanut_init.h"
+
+// Baked level, written by tools/level_baker and mapped straight into memory.
+// The tables are arrays of the structs the spawners take, so chunks are
+// spawned from the mapping in place with nothing to parse. Little endian,
+// every table 4-byte aligned. Clouds and peanuts carry their type and size
+// enums, the textures are picked from those.
+//
+//   LevelFileHeader header
+//   CloudInitData   staticClouds[staticCloudCount]   // Spawned once at startup
+//   LevelFileChunk  chunks[chunkCount]               // Index into the two below
+//   CloudInitData   clouds[cloudCount]
+//   PeanutInitData  peanuts[peanutCount]
+#define LEVEL_FILE_MAGIC "MNLV"
+#define LEVEL_FILE_VERSION 1
+
+// The structs are the format, changing them needs a new version
+static_assert(sizeof(CloudInitData) == 16, "CloudInitData is stored as is in level files");
+static_assert(sizeof(PeanutInitData) == 12, "PeanutInitData is stored as is in level files");
+
+struct LevelFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;          // Seed the chunks were rolled from, 0 for authored levels
+    float startY;           // LEVEL_START_Y and LEVEL_CHUNK_HEIGHT it was baked for
+    float chunkHeight;
+    uint32_t staticCloudCount;
+    uint32_t chunkCount;
+    uint32_t cloudCount;
+    uint32_t peanutCount;
+};
+
+struct LevelFileChunk {
+    uint32_t firstCloud;
+    uint32_t cloudCount;
+    uint32_t firstPeanut;
+    uint32_t peanutCount;
+};
+
+// Byte offsets of the tables for the counts in a header. 64 bit even where
+// size_t is 32 (web, 32-bit Windows), so a bogus count can't wrap the total
+// below the real file size.
+struct LevelFileLayout {
+    uint64_t staticClouds;
+    uint64_t chunks;
+    uint64_t clouds;
+    uint64_t peanuts;
+    uint64_t size;  // Whole file
+
+    void Init(const LevelFileHeader* header) {
+        staticClouds = sizeof(LevelFileHeader);
+        chunks = staticClouds + (uint64_t)header->staticCloudCount * sizeof(CloudInitData);
+        clouds = chunks + (uint64_t)header->chunkCount * sizeof(LevelFileChunk);
+        peanuts = clouds + (uint64_t)header->cloudCount * sizeof(CloudInitData);
+        size = peanuts + (uint64_t)header->peanutCount * sizeof(PeanutInitData);
+    }
+};
+
+struct LevelFile {
+    const LevelFileHeader* header;  // nullptr while nothing is open
+    const CloudInitData* staticClouds;
+    const LevelFileChunk* chunks;
+    const CloudInitData* clouds;
+    const PeanutInitData* peanuts;
+
+    // Maps the file and checks that every table and chunk fits and every
+    // cloud and peanut enum is in range. Prints why and returns false if not.
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+private:
+    void* data;   // The mapping, or a malloc'd copy on the web
+    size_t size;
+
+    bool Validate(const char* path);
+};
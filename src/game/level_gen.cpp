@@ -0,0 +1,209 @@
+#include "level_gen.h"
+#include "../core/random.h"
+#include <math.h>
+#include <string.h>
+
+int LevelChunkCount() {
+    // Peanuts go down to LEVEL_START_Y above the bottom, the chunks cover that
+    return (int)ceilf((GAME_HEIGHT - 2 * LEVEL_START_Y) / LEVEL_CHUNK_HEIGHT);
+}
+
+float LevelChunkTop(int chunk) {
+    return LEVEL_START_Y + (float)chunk * LEVEL_CHUNK_HEIGHT;
+}
+
+uint64_t LevelChunkSeed(uint32_t levelSeed, int chunk) {
+    // Neighbouring chunks get unrelated seeds
+    return SplitMix64(((uint64_t)levelSeed << 32) | (uint32_t)chunk);
+}
+
+// Spacing grid, Bridson-style: with cells MIN_CLOUD_SPACING/sqrt(2) wide no
+// two spaced clouds share a cell, so a candidate only has to look at the 5x5
+// cells around it however many clouds are placed. It covers one chunk. The
+// clouds the chunk above might have in the MIN_CLOUD_SPACING band over it
+// aren't spaced against each other, so they sit in a short list instead.
+#define CLOUD_GRID_CELL (MIN_CLOUD_SPACING * 0.70710678f)
+#define CLOUD_GRID_COLS ((int)(GAME_WIDTH / CLOUD_GRID_CELL) + 1)
+#define CLOUD_GRID_ROWS ((int)(LEVEL_CHUNK_HEIGHT / CLOUD_GRID_CELL) + 1)
+
+struct CloudSpacingGrid {
+    struct Cell {
+        float x, y;
+        bool occupied;
+    };
+
+    float top;  // World y of the first row
+    Cell cells[CLOUD_GRID_ROWS][CLOUD_GRID_COLS];
+    CloudInitData above[MAX_CLOUDS_PER_CHUNK];  // In the band over the chunk
+    int aboveCount;
+
+    void Init(float chunkTop) {
+        top = chunkTop;
+        memset(cells, 0, sizeof(cells));
+        aboveCount = 0;
+    }
+
+    // Only the band right over the chunk can be too close to it
+    void InsertAbove(const CloudInitData& cloud) {
+        if (cloud.y >= top - MIN_CLOUD_SPACING && cloud.y < top && aboveCount < MAX_CLOUDS_PER_CHUNK) {
+            above[aboveCount++] = cloud;
+        }
+    }
+
+    // False if the point is outside the grid
+    bool CellOf(float x, float y, int* col, int* row) {
+        if (x < 0.0f || y < top) return false;
+        *col = (int)(x / CLOUD_GRID_CELL);
+        *row = (int)((y - top) / CLOUD_GRID_CELL);
+        return *col < CLOUD_GRID_COLS && *row < CLOUD_GRID_ROWS;
+    }
+
+    bool IsTooClose(const CloudInitData& cloud) {
+        for (int i = 0; i < aboveCount; i++) {
+            float dx = cloud.x - above[i].x;
+            float dy = cloud.y - above[i].y;
+            if (dx * dx + dy * dy < MIN_CLOUD_SPACING * MIN_CLOUD_SPACING) {
+                return true;
+            }
+        }
+
+        int col, row;
+        if (!CellOf(cloud.x, cloud.y, &col, &row)) return false;
+
+        for (int r = row - 2; r <= row + 2; r++) {
+            if (r < 0 || r >= CLOUD_GRID_ROWS) continue;
+            for (int c = col - 2; c <= col + 2; c++) {
+                if (c < 0 || c >= CLOUD_GRID_COLS || !cells[r][c].occupied) continue;
+
+                float dx = cloud.x - cells[r][c].x;
+                float dy = cloud.y - cells[r][c].y;
+                if (dx * dx + dy * dy < MIN_CLOUD_SPACING * MIN_CLOUD_SPACING) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Clouds outside the grid are too far away to matter and are dropped
+    void Insert(const CloudInitData& cloud) {
+        int col, row;
+        if (!CellOf(cloud.x, cloud.y, &col, &row)) return;
+
+        cells[row][col].x = cloud.x;
+        cells[row][col].y = cloud.y;
+        cells[row][col].occupied = true;
+    }
+};
+
+float GetCloudDensityMultiplier(float y) {
+    // Returns a value between 3.0 and 1.0 based on depth
+    // Less clouds as you go deeper (higher y values)
+    float depthRatio = y / GAME_HEIGHT;
+    return 3.0f - (depthRatio * 2.0f); // Linear decrease down to 1x density
+}
+
+// Rolls the clouds of one chunk from its own seed, spaced against each other
+// and anything already in grid. Every candidate takes the same draws whether
+// it's kept or not, so without a grid this returns all of them: a superset
+// of what the chunk spawns with any grid.
+static int RollChunkClouds(uint32_t levelSeed, int chunk, CloudSpacingGrid* grid, CloudInitData* clouds, int maxCount) {
+    Random random;
+    random.Init(LevelChunkSeed(levelSeed, chunk), CLOUD_RANDOM_STREAM);
+
+    float y = LevelChunkTop(chunk);
+    int cloudCount = 0;
+
+    // Calculate how many clouds to place in this section
+    float densityMultiplier = GetCloudDensityMultiplier(y);
+    int cloudsInSection = (int)(CLOUDS_PER_SECTION * densityMultiplier);
+
+    // Generate clouds for this section
+    for (int i = 0; i < cloudsInSection && cloudCount < maxCount; i++) {
+        CloudInitData cloud;
+        
+        // Random position within game width and current height section
+        cloud.x = (float)random.Range(GAME_WIDTH);
+        cloud.y = y + (float)random.Range(LEVEL_CHUNK_HEIGHT);
+
+        // Determine cloud type (20% chance for black clouds) - CHANGED - ONLY WHITE CLOUDS
+        cloud.type = CLOUD_WHITE;//(random.Range(5) == 0) ? CLOUD_BLACK : CLOUD_WHITE; 
+        cloud.size = (cloud.type == CLOUD_BLACK) ? CLOUD_SIZE_SMALL : (CloudSize)random.Range(3);
+
+        // Check minimum spacing with previously placed clouds
+        if (!grid) {
+            clouds[cloudCount++] = cloud;
+        } else if (!grid->IsTooClose(cloud)) {
+            grid->Insert(cloud);
+            clouds[cloudCount++] = cloud;
+        }
+    }
+    return cloudCount;
+}
+
+int GenerateChunkClouds(uint32_t levelSeed, int chunk, CloudInitData* clouds, int maxCount) {
+    // The bottom sections stay clear for the landing
+    if (LevelChunkTop(chunk) >= GAME_HEIGHT - WINDOW_HEIGHT*3) return 0;
+
+    // Space against every candidate of the chunk above. What it really
+    // spawns is a subset of those whatever its own upper neighbour did, so
+    // the spacing holds across the boundary without depending on generation
+    // order.
+    CloudSpacingGrid grid;
+    grid.Init(LevelChunkTop(chunk));
+
+    if (chunk > 0 && LevelChunkTop(chunk - 1) < GAME_HEIGHT - WINDOW_HEIGHT*3) {
+        CloudInitData above[MAX_CLOUDS_PER_CHUNK];
+        int aboveCount = RollChunkClouds(levelSeed, chunk - 1, nullptr, above, MAX_CLOUDS_PER_CHUNK);
+        for (int i = 0; i < aboveCount; i++) {
+            grid.InsertAbove(above[i]);
+        }
+    }
+
+    return RollChunkClouds(levelSeed, chunk, &grid, clouds, maxCount);
+}
+
+int GenerateChunkPeanuts(uint32_t levelSeed, int chunk, PeanutInitData* peanuts, int maxCount) {
+    // Own stream next to the clouds', so either can change without moving the other
+    Random random;
+    random.Init(LevelChunkSeed(levelSeed, chunk), PEANUT_RANDOM_STREAM);
+
+    // Peanut heights sit on a fixed MIN_PEANUT_SPACING ladder from the level
+    // start, take the rungs inside this chunk
+    float chunkTop = LevelChunkTop(chunk);
+    float chunkBottom = chunkTop + LEVEL_CHUNK_HEIGHT;
+    int rung = (int)ceilf((chunkTop - LEVEL_START_Y) / MIN_PEANUT_SPACING);
+    float currentHeight = LEVEL_START_Y + rung * MIN_PEANUT_SPACING;
+    int peanutCount = 0;
+
+    while (currentHeight < chunkBottom && currentHeight < GAME_HEIGHT - LEVEL_START_Y) {  // Stop before bottom
+        // Decide if we spawn a peanut at this height
+        if (random.Float() < PEANUT_SPAWN_CHANCE && peanutCount < maxCount) {
+            // Random x position within reasonable bounds
+            float x = 800.0f + (float)random.Range(800);  // Between 800 and 1600
+
+            // Determine peanut type
+            PeanutType type;
+            float typeRoll = random.Float();
+            
+            if (typeRoll < SUPER_PEANUT_CHANCE) {
+                type = PEANUT_TYPE_SUPER;
+            } else if (typeRoll < SUPER_PEANUT_CHANCE + SHIELD_PEANUT_CHANCE) {
+                type = PEANUT_TYPE_SHIELD;
+            } else {
+                type = PEANUT_TYPE_REGULAR;
+            }
+            
+            peanuts[peanutCount++] = {x, currentHeight, type};
+            
+            // printf("Generated %s peanut at (%.1f, %.1f)\n", 
+            //     type == PEANUT_TYPE_SUPER ? "super" : 
+            //     type == PEANUT_TYPE_SHIELD ? "shield" : "regular",
+            //     x, currentHeight);
+        }
+        
+        currentHeight += MIN_PEANUT_SPACING;
+    }
+
+    return peanutCount;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "../core/engine_constants.h"
+#include "cloud_init.h"
+#include "peanut_init.h"
+
+// Procedural level layout. Below LEVEL_START_Y the level is cut into chunks
+// one window tall, and a chunk's clouds and peanuts only depend on the level
+// seed and the chunk index. Nothing here touches the engine, so the level
+// baker tool builds the same layouts offline.
+#define LEVEL_START_Y 500.0f
+#define LEVEL_CHUNK_HEIGHT WINDOW_HEIGHT
+#define LEVEL_SEED 5            // Used unless --seed or --daily picks another
+#define CLOUD_RANDOM_STREAM 1   // PCG streams of one chunk seed
+#define PEANUT_RANDOM_STREAM 2
+
+int LevelChunkCount();
+float LevelChunkTop(int chunk);
+uint64_t LevelChunkSeed(uint32_t levelSeed, int chunk);
+
+// Roll the clouds / peanuts of one chunk, return how many were written
+int GenerateChunkClouds(uint32_t levelSeed, int chunk, CloudInitData* clouds, int maxCount);
+int GenerateChunkPeanuts(uint32_t levelSeed, int chunk, PeanutInitData* peanuts, int maxCount);
+
+float GetCloudDensityMultiplier(float y); // Returns higher values as y increases
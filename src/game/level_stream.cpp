@@ -0,0 +1,171 @@
+#include "level_stream.h"
+#include "../core/engine.h"
+#include "../core/job_system.h"
+#include <math.h>
+#include <string.h>
+
+LevelChunk LevelStream::chunks[MAX_LIVE_CHUNKS];
+uint32_t LevelStream::levelSeed = LEVEL_SEED;
+GrowableArray<uint32_t> LevelStream::collectedPeanuts;
+LevelFile LevelStream::levelFile;
+
+void LevelStream::Init(uint32_t seed, const char* levelPath) {
+    levelSeed = seed;
+    if (levelPath && !levelFile.Open(levelPath)) {
+        printf("LevelStream: generating the level instead\n");
+    }
+    for (int i = 0; i < MAX_LIVE_CHUNKS; i++) {
+        chunks[i].index = -1;
+        chunks[i].cloudCount = 0;
+        chunks[i].peanutCount = 0;
+    }
+
+    collectedPeanuts.Init();
+    collectedPeanuts.Reserve(ChunkCount());
+    collectedPeanuts.count = ChunkCount();
+    ResetCollected();
+
+    if (levelFile.IsOpen()) {
+        printf("LevelStream: %d chunks of %dpx from the level file\n", ChunkCount(), LEVEL_CHUNK_HEIGHT);
+    } else {
+        printf("LevelStream: %d chunks of %dpx, seed %u\n", ChunkCount(), LEVEL_CHUNK_HEIGHT, levelSeed);
+    }
+}
+
+int LevelStream::ChunkCount() {
+    return levelFile.IsOpen() ? (int)levelFile.header->chunkCount : LevelChunkCount();
+}
+
+void LevelStream::SpawnStaticClouds() {
+    if (levelFile.IsOpen()) {
+        CreateCloudsFromData(levelFile.staticClouds, levelFile.header->staticCloudCount);
+    } else {
+        CreateCloudsFromData(cloudList, sizeof(cloudList) / sizeof(CloudInitData));
+    }
+}
+
+void LevelStream::Destroy() {
+    for (int i = 0; i < MAX_LIVE_CHUNKS; i++) {
+        if (chunks[i].index >= 0) Recycle(&chunks[i]);
+    }
+    collectedPeanuts.Destroy();
+    levelFile.Close();
+}
+
+void LevelStream::ResetCollected() {
+    for (uint32_t i = 0; i < collectedPeanuts.count; i++) {
+        collectedPeanuts[i] = 0;
+    }
+}
+
+bool LevelStream::Update(float cameraY) {
+    int cameraChunk = (int)floorf((cameraY - LEVEL_START_Y) / LEVEL_CHUNK_HEIGHT);
+    int first = cameraChunk - LEVEL_CHUNKS_BEHIND;
+    int last = cameraChunk + LEVEL_CHUNKS_AHEAD;
+    if (first < 0) first = 0;
+    if (last > ChunkCount() - 1) last = ChunkCount() - 1;
+
+    bool changed = false;
+
+    // Out of range chunks first, their slots are the free ones below
+    for (int i = 0; i < MAX_LIVE_CHUNKS; i++) {
+        if (chunks[i].index >= 0 && (chunks[i].index < first || chunks[i].index > last)) {
+            Recycle(&chunks[i]);
+            changed = true;
+        }
+    }
+
+    // Roll the missing chunks side by side, top to bottom
+    static ChunkRoll rolls[MAX_LIVE_CHUNKS];
+    int rollCount = 0;
+    for (int index = first; index <= last; index++) {
+        bool live = false;
+        for (int i = 0; i < MAX_LIVE_CHUNKS; i++) {
+            if (chunks[i].index == index) live = true;
+        }
+        if (!live) rolls[rollCount++].index = index;
+    }
+
+    JobSystem::ParallelFor(rollCount, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; r++) {
+            Roll(&rolls[r]);
+        }
+    });
+
+    // Entities are only created here, in the same order every time
+    for (int r = 0; r < rollCount; r++) {
+        for (int i = 0; i < MAX_LIVE_CHUNKS; i++) {
+            if (chunks[i].index < 0) {
+                Spawn(&chunks[i], &rolls[r]);
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    return changed;
+}
+
+void LevelStream::Roll(ChunkRoll* roll) {
+    if (levelFile.IsOpen()) {
+        // Already checked to fit when the file was opened
+        const LevelFileChunk& chunk = levelFile.chunks[roll->index];
+        roll->cloudData = levelFile.clouds + chunk.firstCloud;
+        roll->cloudCount = chunk.cloudCount;
+        roll->peanutData = levelFile.peanuts + chunk.firstPeanut;
+        roll->peanutCount = chunk.peanutCount;
+        return;
+    }
+
+    roll->cloudData = roll->clouds;
+    roll->cloudCount = GenerateChunkClouds(levelSeed, roll->index, roll->clouds, MAX_CLOUDS_PER_CHUNK);
+    roll->peanutData = roll->peanuts;
+    roll->peanutCount = GenerateChunkPeanuts(levelSeed, roll->index, roll->peanuts, MAX_PEANUTS_PER_CHUNK);
+}
+
+void LevelStream::Spawn(LevelChunk* chunk, const ChunkRoll* roll) {
+    int index = roll->index;
+    chunk->index = index;
+
+    chunk->cloudCount = roll->cloudCount;
+    CreateCloudsFromData(roll->cloudData, roll->cloudCount, chunk->clouds);
+
+    chunk->peanutCount = roll->peanutCount;
+    CreatePeanutsFromData(roll->peanutData, roll->peanutCount, chunk->peanuts);
+
+    // Peanuts eaten before the chunk was last recycled stay eaten
+    uint32_t collected = collectedPeanuts[index];
+    for (int i = 0; i < chunk->peanutCount; i++) {
+        EntityID entity = chunk->peanuts[i];
+        if (!(collected & (1u << i)) || !entity) continue;
+
+        g_Engine.componentArrays.peanuts[entity].wasCollected = true;
+        g_Engine.componentArrays.sprites[entity].isVisible = false;
+    }
+}
+
+void LevelStream::Recycle(LevelChunk* chunk) {
+    EntityManager* entities = &g_Engine.entityManager;
+
+    uint32_t collected = 0;
+    for (int i = 0; i < chunk->peanutCount; i++) {
+        EntityID entity = chunk->peanuts[i];
+        if (!entities->IsEntityValid(entity)) continue;
+
+        if (g_Engine.componentArrays.peanuts[entity].wasCollected) {
+            collected |= 1u << i;
+        }
+        entities->DestroyEntity(entity);
+    }
+    collectedPeanuts[chunk->index] = collected;
+
+    for (int i = 0; i < chunk->cloudCount; i++) {
+        if (entities->IsEntityValid(chunk->clouds[i])) {
+            entities->DestroyEntity(chunk->clouds[i]);
+        }
+    }
+
+    chunk->index = -1;
+    chunk->cloudCount = 0;
+    chunk->peanutCount = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "../core/ecs/ecs_types.h"
+#include "../core/ecs/paged_array.h"
+#include "level_gen.h"
+#include "level_file.h"
+
+// Keeps the level chunks (see level_gen.h) around the camera alive. A chunk
+// is rolled from its own seed when the camera gets close and its entities
+// are destroyed again once the camera is past it, so only a few screens of
+// clouds and peanuts are alive however tall the level is. Chunks are rolled
+// on the job threads and only spawned on the calling one. With a baked level
+// file the chunks are spawned straight from its mapped tables instead.
+#define LEVEL_CHUNKS_BEHIND 1   // Kept above the camera's chunk
+#define LEVEL_CHUNKS_AHEAD 2    // Spawned below it, the view spans two chunks
+#define MAX_LIVE_CHUNKS (LEVEL_CHUNKS_BEHIND + 1 + LEVEL_CHUNKS_AHEAD)
+
+struct LevelChunk {
+    int index;  // -1 when the slot is free
+    EntityID clouds[MAX_CLOUDS_PER_CHUNK];
+    int cloudCount;
+    EntityID peanuts[MAX_PEANUTS_PER_CHUNK];  // In roll order, 0 if not spawned
+    int peanutCount;
+};
+
+// What a chunk rolled, before anything is spawned. The data pointers go to
+// the arrays here or into the level file.
+struct ChunkRoll {
+    int index;
+    const CloudInitData* cloudData;
+    int cloudCount;
+    const PeanutInitData* peanutData;
+    int peanutCount;
+
+    CloudInitData clouds[MAX_CLOUDS_PER_CHUNK];
+    PeanutInitData peanuts[MAX_PEANUTS_PER_CHUNK];
+};
+
+struct LevelStream {
+    // levelPath is a baked level to stream from. Without one, or if it
+    // doesn't load, the level is generated from seed.
+    static void Init(uint32_t seed, const char* levelPath = nullptr);
+    static void Destroy();
+
+    // The clouds above the first chunk, from the level file or cloudList
+    static void SpawnStaticClouds();
+
+    // Spawns the chunks around cameraY and recycles the rest. Returns true
+    // if any chunk came or went.
+    static bool Update(float cameraY);
+
+    // Forgets which peanuts were collected, for a new run
+    static void ResetCollected();
+
+    static uint32_t LevelSeed() { return levelSeed; }
+    static int ChunkCount();
+
+private:
+    static LevelChunk chunks[MAX_LIVE_CHUNKS];
+    static uint32_t levelSeed;
+    static LevelFile levelFile;
+
+    // Collected peanuts of every chunk, one bit per roll-order index, so a
+    // chunk that is scrolled back to doesn't hand them out again
+    static GrowableArray<uint32_t> collectedPeanuts;
+
+    static void Roll(ChunkRoll* roll);
+    static void Spawn(LevelChunk* chunk, const ChunkRoll* roll);
+    static void Recycle(LevelChunk* chunk);
+};
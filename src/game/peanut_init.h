@@ -1,5 +1,6 @@
 #pragma once
 #include "../core/ecs/components/peanut_components.h"
+#include "../core/ecs/ecs_types.h"
 
 // Data structure for initializing peanuts
 struct PeanutInitData {
@@ -9,12 +10,18 @@ struct PeanutInitData {
 };
 
 // Function declarations
-void CreatePeanutsFromData(const PeanutInitData* peanutList, int count);
-void GenerateRandomPeanuts(float spawnThreshold);
+// Builds the peanut prefabs, once the textures are loaded and before any spawn
+void InitPeanutPrefabs();
+// The ID of each spawned peanut is written to spawned at its list index if
+// given, 0 for skipped entries. Returns how many were spawned.
+int CreatePeanutsFromData(const PeanutInitData* peanutList, int count, EntityID* spawned = nullptr);
 void MakeAllPeanutsVisibleAgain();
 
 // Constants for peanut generation
 #define MIN_PEANUT_SPACING 300.0f      // Minimum vertical space between peanuts
 #define PEANUT_SPAWN_CHANCE 0.3f       // 30% chance to spawn a peanut at each threshold
 #define SUPER_PEANUT_CHANCE 0.0f       // 0% chance for a peanut to be super
+#define MAX_PEANUTS 256                // Most peanuts spawned by one CreatePeanutsFromData call
+#define MAX_PEANUTS_PER_CHUNK 3        // LEVEL_CHUNK_HEIGHT / MIN_PEANUT_SPACING, rounded up
+#define PEANUT_PREFAB_COUNT 3          // One per PeanutType
 #define SHIELD_PEANUT_CHANCE 0.0f      // 0% chance for a peanut to be shield 
\ No newline at end of file
@@ -1,23 +1,114 @@
 #include "core/engine.h"
 #include "game/game.h"
+#include "game/level_stream.h"
+#include "core/input_recorder.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C"
 #endif
 int main(int argc, char* argv[]) {
     //TestEntityManager();
+    //TestCollisionSystem();
+    //BenchmarkSpatialGrid();
+    //BenchmarkComponentLayout();
     
-    if (!Engine::Init()) {
+    // --vsync (default), --fps N to cap without vsync, --uncapped
+    FrameMode frameMode = FRAME_MODE_VSYNC;
+    int targetFps = TARGET_FPS;
+    float timeScale = 1.0f;
+#ifdef HEADLESS
+    int headlessFrames = 10000;
+    bool framesGiven = false;
+#endif
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* profileCsvPath = nullptr;
+    int workerThreads = -1;
+    uint32_t levelSeed = LEVEL_SEED;
+    const char* levelPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--vsync") == 0) {
+            frameMode = FRAME_MODE_VSYNC;
+        } else if (strcmp(argv[i], "--uncapped") == 0) {
+            frameMode = FRAME_MODE_UNCAPPED;
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            frameMode = FRAME_MODE_CAPPED;
+            targetFps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--timescale") == 0 && i + 1 < argc) {
+            // Runs the simulation N times faster than real time
+            timeScale = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            // Headless builds only: number of frames to simulate
+            i++;
+#ifdef HEADLESS
+            headlessFrames = atoi(argv[i]);
+            framesGiven = true;
+#endif
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            // Writes every frame's input and time to an input log
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            // Plays an input log back instead of reading the keyboard
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            // Writes the per-system profiler stats to a CSV file on exit
+            profileCsvPath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            // Worker threads for the system scheduler, 0 runs everything on the main thread
+            workerThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            // Level seed, the same seed always builds the same level
+            levelSeed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            // Baked level file (make bake-level), generated from the seed if it can't be loaded
+            levelPath = argv[++i];
+        } else if (strcmp(argv[i], "--daily") == 0) {
+            // Today's level, seeded with the local date as YYYYMMDD
+            time_t now = time(nullptr);
+            struct tm* date = localtime(&now);
+            levelSeed = (uint32_t)((date->tm_year + 1900) * 10000 + (date->tm_mon + 1) * 100 + date->tm_mday);
+        }
+    }
+
+    if (!Engine::Init(frameMode, targetFps, workerThreads)) {
         printf("Engine initialization failed!\n");
         return -1;
     }
     
+    // Set up the input log first, a replay brings the seed its level was built with
+    g_Engine.timeScale = timeScale;
+    g_Engine.profileCsvPath = profileCsvPath;
+    if (replayPath) {
+        // The log brings its own time scale, so steps line up with the recording
+        if (!InputRecorder::StartReplay(replayPath, &g_Engine.timeScale, &levelSeed)) {
+            return -1;
+        }
+#ifdef HEADLESS
+        if (!framesGiven) {
+            headlessFrames = 0x7FFFFFFF;  // Run until the log ends
+        }
+#endif
+    } else if (recordPath) {
+        if (!InputRecorder::StartRecording(recordPath, g_Engine.timeScale, levelSeed)) {
+            return -1;
+        }
+    }
+
+    g_Game.levelSeed = levelSeed;
+    g_Game.levelPath = levelPath;
     if (!g_Game.Init()) {
         printf("Game initialization failed!\n");
         return -1;
     }
-    
+
+#ifdef HEADLESS
+    g_Engine.RunHeadless(headlessFrames);
+#else
     g_Engine.Run();
+#endif
     
     g_Game.Cleanup();
     Engine::Cleanup();
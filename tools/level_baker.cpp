@@ -0,0 +1,84 @@
+// Bakes a level file (layout in src/game/level_file.h) from the level
+// generator, with cloudList as the static clouds. The game streams it with
+// --level instead of rolling the chunks itself. Authored levels can be
+// written the same way from other data.
+//
+//   level_baker [--seed N] out.mnlv
+#include "game/level_gen.h"
+#include "game/level_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = LEVEL_SEED;
+    const char* outPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            outPath = argv[i];
+        }
+    }
+    if (!outPath) {
+        printf("Usage: level_baker [--seed N] out.mnlv\n");
+        return 1;
+    }
+
+    // Roll every chunk into one table per kind, the chunk table points into them
+    int chunkCount = LevelChunkCount();
+    LevelFileChunk* chunks = (LevelFileChunk*)malloc(chunkCount * sizeof(LevelFileChunk));
+    CloudInitData* clouds = (CloudInitData*)malloc(chunkCount * MAX_CLOUDS_PER_CHUNK * sizeof(CloudInitData));
+    PeanutInitData* peanuts = (PeanutInitData*)malloc(chunkCount * MAX_PEANUTS_PER_CHUNK * sizeof(PeanutInitData));
+    uint32_t cloudCount = 0;
+    uint32_t peanutCount = 0;
+
+    for (int i = 0; i < chunkCount; i++) {
+        chunks[i].firstCloud = cloudCount;
+        chunks[i].cloudCount = GenerateChunkClouds(seed, i, clouds + cloudCount, MAX_CLOUDS_PER_CHUNK);
+        cloudCount += chunks[i].cloudCount;
+
+        chunks[i].firstPeanut = peanutCount;
+        chunks[i].peanutCount = GenerateChunkPeanuts(seed, i, peanuts + peanutCount, MAX_PEANUTS_PER_CHUNK);
+        peanutCount += chunks[i].peanutCount;
+    }
+
+    LevelFileHeader header;
+    memcpy(header.magic, LEVEL_FILE_MAGIC, 4);
+    header.version = LEVEL_FILE_VERSION;
+    header.seed = seed;
+    header.startY = LEVEL_START_Y;
+    header.chunkHeight = LEVEL_CHUNK_HEIGHT;
+    header.staticCloudCount = sizeof(cloudList) / sizeof(CloudInitData);
+    header.chunkCount = chunkCount;
+    header.cloudCount = cloudCount;
+    header.peanutCount = peanutCount;
+
+    FILE* file = fopen(outPath, "wb");
+    if (!file) {
+        printf("Failed to open %s for writing\n", outPath);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(cloudList, sizeof(CloudInitData), header.staticCloudCount, file);
+    fwrite(chunks, sizeof(LevelFileChunk), chunkCount, file);
+    fwrite(clouds, sizeof(CloudInitData), cloudCount, file);
+    fwrite(peanuts, sizeof(PeanutInitData), peanutCount, file);
+    bool failed = ferror(file) != 0;
+    fclose(file);
+
+    free(chunks);
+    free(clouds);
+    free(peanuts);
+
+    if (failed) {
+        printf("Failed to write %s\n", outPath);
+        return 1;
+    }
+
+    LevelFileLayout layout;
+    layout.Init(&header);
+    printf("Baked seed %u into %s: %d chunks, %u clouds, %u peanuts, %lu bytes\n",
+           seed, outPath, chunkCount, cloudCount, peanutCount, (unsigned long)layout.size);
+    return 0;
+}